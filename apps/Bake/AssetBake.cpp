@@ -0,0 +1,250 @@
+#include <GameCommon/Common.h>
+#include <GameCommon/AssetPack.h>
+#include <GameCommon/LevelTemplate.h>
+#include <GameCommon/TextRenderer.h>
+
+#include <cstring>
+#include <filesystem>
+
+// Bakes everything under a resource directory into one gcom::AssetPack, which
+// the client maps at startup instead of decoding the loose files. Run it from
+// the repository root after changing anything in res/:
+//   ./AssetBake [resource directory] [pack] [font size]
+// The defaults are res, res/assets.pack and 24, the size the game draws text
+// at. Assets are named by their path, e.g. res/textures/ball.png, which is how
+// the game asks for them, so the resource directory has to be given the same way.
+
+namespace
+{
+namespace fs = std::filesystem;
+using Kind   = gcom::AssetPack::Kind;
+
+struct Baked
+{
+    Kind kind;
+    std::string name;
+    u32 width{ 0 };
+    u32 height{ 0 };
+    u32 font_size{ 0 };
+    std::vector<u8> data{};
+};
+
+std::vector<u8> read_bytes(const fs::path& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    return std::vector<u8>{ std::istreambuf_iterator<char>{ file },
+                            std::istreambuf_iterator<char>{} };
+}
+
+template <typename T> void append(std::vector<u8>& out, const T& value)
+{
+    const auto* bytes{ reinterpret_cast<const u8*>(&value) };
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+std::optional<Baked> bake_texture(const fs::path& path, std::string name)
+{
+    int width{};
+    int height{};
+    int nr_channels{};
+    unsigned char* pixels{
+        stbi_load(path.string().c_str(), &width, &height, &nr_channels, 4)
+    };
+    if (!pixels)
+    {
+        std::cerr << "Skipping " << name << ": " << stbi_failure_reason() << "\n";
+        return std::nullopt;
+    }
+    Baked baked{ Kind::Texture,
+                 std::move(name),
+                 static_cast<u32>(width),
+                 static_cast<u32>(height) };
+    baked.data.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+    return baked;
+}
+
+Baked bake_font(const fs::path& path, std::string name, u32 font_size)
+{
+    const gcom::GlyphAtlas atlas{ gcom::TextRender::rasterize(path.string(),
+                                                              font_size) };
+    Baked baked{ Kind::Font,
+                 std::move(name),
+                 static_cast<u32>(atlas.width),
+                 static_cast<u32>(atlas.height),
+                 font_size };
+    for (const gcom::Character& character : atlas.characters)
+    {
+        append(baked.data, gcom::AssetPack::to_glyph(character));
+    }
+    baked.data.insert(baked.data.end(), atlas.pixels.begin(), atlas.pixels.end());
+    return baked;
+}
+
+Baked bake_level(const fs::path& path, std::string name)
+{
+    const std::vector<std::vector<u32>> tiles{ gcom::LevelTemplate::read_tiles(
+        path.string()) };
+    Baked baked{ Kind::Level, std::move(name), 0, static_cast<u32>(tiles.size()) };
+    for (const std::vector<u32>& row : tiles)
+    {
+        append(baked.data, static_cast<u32>(row.size()));
+        for (const u32 tile : row)
+        {
+            append(baked.data, tile);
+        }
+    }
+    return baked;
+}
+
+std::optional<Baked> bake(const fs::path& path, u32 font_size)
+{
+    std::string name{ path.generic_string() };
+    std::string extension{ path.extension().string() };
+    std::transform(extension.begin(),
+                   extension.end(),
+                   extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == ".png" || extension == ".jpg" || extension == ".jpeg")
+    {
+        return bake_texture(path, std::move(name));
+    }
+    if (extension == ".vert" || extension == ".frag" || extension == ".geom")
+    {
+        Baked baked{ Kind::Shader, std::move(name) };
+        baked.data = read_bytes(path);
+        baked.data.push_back(0); // compiled straight from the pack as a C string
+        return baked;
+    }
+    if (extension == ".ttf")
+    {
+        return bake_font(path, std::move(name), font_size);
+    }
+    if (extension == ".lvl")
+    {
+        return bake_level(path, std::move(name));
+    }
+    if (extension == ".wav" || extension == ".mp3" || extension == ".flac")
+    {
+        Baked baked{ Kind::Audio, std::move(name) };
+        baked.data = read_bytes(path);
+        return baked;
+    }
+    return std::nullopt;
+}
+
+u64 align(u64 offset)
+{
+    const u64 alignment{ gcom::AssetPack::PACK_ALIGNMENT };
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool write_pack(const fs::path& path, const std::vector<Baked>& assets)
+{
+    using gcom::AssetPack;
+
+    std::string names{};
+    std::vector<AssetPack::PackEntry> entries{};
+    for (const Baked& asset : assets)
+    {
+        entries.push_back(AssetPack::PackEntry{ asset.kind,
+                                                static_cast<u32>(names.size()),
+                                                static_cast<u32>(asset.name.size()),
+                                                asset.width,
+                                                asset.height,
+                                                asset.font_size,
+                                                0,
+                                                asset.data.size() });
+        names += asset.name;
+        names += '\0';
+    }
+
+    u64 offset{ sizeof(AssetPack::PackHeader) +
+                entries.size() * sizeof(AssetPack::PackEntry) + names.size() };
+    for (AssetPack::PackEntry& entry : entries)
+    {
+        entry.offset = align(offset);
+        offset       = entry.offset + entry.size;
+    }
+
+    std::vector<u8> pack{};
+    pack.reserve(offset);
+    append(pack,
+           AssetPack::PackHeader{ AssetPack::MAGIC,
+                                  AssetPack::VERSION,
+                                  static_cast<u32>(entries.size()),
+                                  static_cast<u32>(names.size()) });
+    for (const AssetPack::PackEntry& entry : entries)
+    {
+        append(pack, entry);
+    }
+    pack.insert(pack.end(), names.begin(), names.end());
+    for (size_t i{ 0 }; i < assets.size(); ++i)
+    {
+        pack.resize(entries[i].offset, 0);
+        pack.insert(pack.end(), assets[i].data.begin(), assets[i].data.end());
+    }
+
+    std::ofstream file{ path, std::ios::binary };
+    file.write(reinterpret_cast<const char*>(pack.data()),
+               static_cast<std::streamsize>(pack.size()));
+    return static_cast<bool>(file);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const fs::path root{ argc > 1 ? argv[1] : "res" };
+    const fs::path output{ argc > 2 ? argv[2] : "res/assets.pack" };
+    const auto font_size{ static_cast<u32>(argc > 3 ? std::atoi(argv[3]) : 24) };
+
+    if (!fs::is_directory(root))
+    {
+        std::cerr << root.generic_string() << " is not a directory\n";
+        return 1;
+    }
+
+    std::vector<fs::path> files{};
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator{ root })
+    {
+        // the pack doesn't exist yet on the first bake, which is an error for
+        // equivalent() on some standard libraries
+        std::error_code error{};
+        if (entry.is_regular_file() && !fs::equivalent(entry.path(), output, error))
+        {
+            files.push_back(entry.path());
+        }
+    }
+    // the same pack for the same files, whatever order the directory lists them in
+    std::sort(files.begin(), files.end());
+
+    std::vector<Baked> assets{};
+    std::array<u64, 5> bytes{}; // per Kind
+    for (const fs::path& file : files)
+    {
+        if (std::optional<Baked> baked{ bake(file, font_size) })
+        {
+            bytes[static_cast<size_t>(baked->kind)] += baked->data.size();
+            assets.push_back(std::move(*baked));
+        }
+    }
+
+    if (!write_pack(output, assets))
+    {
+        std::cerr << "Failed to write " << output.generic_string() << "\n";
+        return 1;
+    }
+
+    constexpr std::array<std::string_view, 5> KINDS{
+        "textures", "shaders", "fonts", "levels", "audio"
+    };
+    std::cout << "Baked " << assets.size() << " assets into "
+              << output.generic_string() << " (" << fs::file_size(output)
+              << " bytes)\n";
+    for (size_t i{ 0 }; i < KINDS.size(); ++i)
+    {
+        std::cout << "  " << KINDS[i] << ": " << bytes[i] << " bytes\n";
+    }
+    return 0;
+}
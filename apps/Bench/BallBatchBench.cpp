@@ -0,0 +1,231 @@
+#include <GameCommon/Types.h>
+#include <GameCommon/BallBatch.h>
+#include <GameCommon/BallDesc.h>
+#include "Bench.h"
+
+#include <random>
+
+// Compares stepping balls one object at a time, the way Match and BallObject used
+// to, with stepping them through gcom::BallBatch.
+
+namespace
+{
+constexpr glm::vec2 BOUNDS{ 800.0f, 600.0f };
+constexpr glm::vec2 PADDLE_SIZE{ 100.0f, 20.0f };
+constexpr float BALL_RADIUS{ 12.5f };
+constexpr float DT{ 1.0f / 120.0f };
+
+struct Paddle
+{
+    glm::vec2 pos;
+    glm::vec2 size;
+};
+
+// One heap allocated ball with its own paddles, like a Match holding a BallDesc
+struct ObjectBall
+{
+    BallDesc ball;
+    std::array<Paddle, 2> paddles;
+    u8 hits{ 0 };
+};
+
+void move(BallDesc& ball, float dt)
+{
+    if (!ball.stuck)
+    {
+        ball.pos += ball.velocity * dt;
+        if (ball.pos.x <= 0.0f)
+        {
+            ball.velocity.x = -ball.velocity.x;
+            ball.pos.x      = 0.0f;
+        }
+        else if (ball.pos.x + ball.size.x >= BOUNDS.x)
+        {
+            ball.velocity.x = -ball.velocity.x;
+            ball.pos.x      = BOUNDS.x - ball.size.x;
+        }
+        if (ball.pos.y <= 0.0f)
+        {
+            ball.velocity.y = -ball.velocity.y;
+            ball.pos.y      = 0.0f;
+        }
+        else if (ball.pos.y + ball.size.y >= BOUNDS.y)
+        {
+            ball.velocity.y = -ball.velocity.y;
+            ball.pos.y      = BOUNDS.y - ball.size.y;
+        }
+    }
+}
+
+bool check_collision(const BallDesc& one, const Paddle& two)
+{
+    glm::vec2 center{ one.pos + one.radius };
+    glm::vec2 aabb_half_extents{ two.size.x / 2.0f, two.size.y / 2.0f };
+    glm::vec2 aabb_center{ two.pos.x + aabb_half_extents.x,
+                           two.pos.y + aabb_half_extents.y };
+    glm::vec2 difference{ center - aabb_center };
+    glm::vec2 clamped{ glm::clamp(difference, -aabb_half_extents, aabb_half_extents) };
+    glm::vec2 closest{ aabb_center + clamped };
+    difference = closest - center;
+    return glm::length(difference) <= one.radius;
+}
+
+BallDesc random_ball(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> x{ 0.0f, BOUNDS.x - BALL_RADIUS * 2.0f };
+    std::uniform_real_distribution<float> y{ 0.0f, BOUNDS.y - BALL_RADIUS * 2.0f };
+    std::uniform_real_distribution<float> v{ -400.0f, 400.0f };
+
+    return BallDesc{ BALL_RADIUS,
+                     false,
+                     glm::vec2{ x(rng), y(rng) },
+                     glm::vec2{ v(rng), v(rng) },
+                     glm::vec2{ BALL_RADIUS * 2.0f, BALL_RADIUS * 2.0f } };
+}
+
+std::array<Paddle, 2> make_paddles()
+{
+    return { Paddle{ glm::vec2{ BOUNDS.x / 2.0f - PADDLE_SIZE.x / 2.0f,
+                                BOUNDS.y - PADDLE_SIZE.y },
+                     PADDLE_SIZE },
+             Paddle{ glm::vec2{ BOUNDS.x / 2.0f - PADDLE_SIZE.x / 2.0f, 0.0f },
+                     PADDLE_SIZE } };
+}
+
+void run(size_t count, u32 iterations)
+{
+    std::mt19937 rng{ 1234 };
+
+    std::vector<std::unique_ptr<ObjectBall>> objects{};
+    objects.reserve(count);
+    gcom::BallBatch batch{};
+
+    for (size_t i{ 0 }; i < count; ++i)
+    {
+        const BallDesc ball{ random_ball(rng) };
+        const auto paddles{ make_paddles() };
+
+        objects.push_back(std::make_unique<ObjectBall>(ObjectBall{ ball, paddles }));
+
+        const gcom::BallBatch::Slot slot{ batch.add(ball, BOUNDS) };
+        batch.set_active(slot, true);
+        for (u32 paddle{ 0 }; paddle < paddles.size(); ++paddle)
+        {
+            batch.set_paddle(slot, paddle, paddles[paddle].pos, paddles[paddle].size);
+        }
+    }
+
+    // Objects are visited in a shuffled order, matches don't live in a tidy array
+    std::shuffle(objects.begin(), objects.end(), rng);
+
+    const double per_object_us{ bench::time_us(
+        iterations,
+        [&objects]()
+        {
+            for (auto& object : objects)
+            {
+                move(object->ball, DT);
+                object->hits = 0;
+                for (u32 paddle{ 0 }; paddle < object->paddles.size(); ++paddle)
+                {
+                    if (check_collision(object->ball, object->paddles[paddle]))
+                    {
+                        object->hits |= static_cast<u8>(1u << paddle);
+                    }
+                }
+            }
+            bench::do_not_optimize(objects.front()->hits);
+        }) };
+
+    const double batched_us{ bench::time_us(iterations,
+                                            [&batch]()
+                                            {
+                                                batch.integrate(DT);
+                                                batch.collide_paddles();
+                                                bench::do_not_optimize(
+                                                    batch.hit_mask(0));
+                                            }) };
+
+    bench::print_row("per-object step", count, per_object_us);
+    bench::print_row("batched step", count, batched_us);
+    std::cout << "speedup: " << std::setprecision(2) << per_object_us / batched_us
+              << "x\n\n";
+}
+
+// Drops balls at the bottom paddle from the middle of the field at `speed`, at
+// angles that all reach the paddle, and counts how many hits an overlap test
+// after every step misses compared with the swept test in BallBatch.
+void run_fast_balls(u32 tick_rate, float speed)
+{
+    constexpr u32 BALLS{ 1'000 };
+    const float dt{ 1.0f / static_cast<float>(tick_rate) };
+    const Paddle paddle{ make_paddles()[0] };
+
+    std::mt19937 rng{ 1234 };
+    std::uniform_real_distribution<float> x{ paddle.pos.x,
+                                             paddle.pos.x + paddle.size.x };
+
+    u32 discrete_missed{ 0 };
+    u32 swept_missed{ 0 };
+    gcom::BallBatch batch{};
+    for (u32 i{ 0 }; i < BALLS; ++i)
+    {
+        // aim the center at a point on the paddle's top edge
+        const glm::vec2 start{ BOUNDS.x / 2.0f - BALL_RADIUS, BOUNDS.y / 2.0f };
+        const glm::vec2 target{ x(rng) - BALL_RADIUS, paddle.pos.y - BALL_RADIUS };
+        const glm::vec2 velocity{ glm::normalize(target - start) * speed };
+        const BallDesc ball{ BALL_RADIUS,
+                             false,
+                             start,
+                             velocity,
+                             glm::vec2{ BALL_RADIUS * 2.0f, BALL_RADIUS * 2.0f } };
+
+        // both stop at the first hit or when the ball reaches the bottom edge
+        BallDesc discrete{ ball };
+        bool discrete_hit{ false };
+        while (!discrete_hit && discrete.velocity.y > 0.0f)
+        {
+            move(discrete, dt);
+            discrete_hit = check_collision(discrete, paddle);
+        }
+        discrete_missed += discrete_hit ? 0 : 1;
+
+        const gcom::BallBatch::Slot slot{ batch.add(ball, BOUNDS) };
+        batch.set_active(slot, true);
+        batch.set_paddle(slot, 0, paddle.pos, paddle.size);
+        bool swept_hit{ false };
+        while (!swept_hit && batch.get(slot).velocity.y > 0.0f)
+        {
+            batch.integrate(dt);
+            batch.collide_paddles();
+            swept_hit = (batch.hit_mask(slot) & 1u) != 0;
+        }
+        swept_missed += swept_hit ? 0 : 1;
+        batch.remove(slot);
+    }
+
+    std::cout << std::left << std::setw(6) << tick_rate << std::right << std::setw(8)
+              << std::fixed << std::setprecision(0) << speed << std::setw(12)
+              << discrete_missed << std::setw(12) << swept_missed << "\n";
+}
+} // namespace
+
+void bench::run_ball_batch()
+{
+    std::cout << "Ball stepping, average time per sim step\n\n";
+    run(1'000, 2000);
+    run(10'000, 500);
+    run(100'000, 50);
+
+    // 350 px/s after no, 10, 15 and 20 speed power-ups
+    std::cout << "Paddle hits missed out of 1000, overlap test vs swept test\n\n"
+              << "Hz       px/s     overlap      swept\n";
+    for (const u32 tick_rate : { 30u, 60u, 120u })
+    {
+        for (const float speed : { 350.0f, 2167.0f, 5394.0f, 13417.0f })
+        {
+            run_fast_balls(tick_rate, speed);
+        }
+    }
+    std::cout << "\n";
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <GameCommon/Types.h>
+
+#include <iomanip>
+
+// Tiny timing helpers shared by the benchmark executables. They only time wall
+// clock and print plain text, so results are comparable between runs on the same
+// machine and nothing more.
+namespace bench
+{
+// Runs fn() `iterations` times and returns the average time of one call in
+// microseconds. One untimed warm-up call runs first.
+template <typename Fn> double time_us(u32 iterations, Fn&& fn)
+{
+    fn();
+
+    const auto start{ std::chrono::steady_clock::now() };
+    for (u32 i{ 0 }; i < iterations; ++i)
+    {
+        fn();
+    }
+    const auto end{ std::chrono::steady_clock::now() };
+
+    return std::chrono::duration<double, std::micro>{ end - start }.count() /
+           static_cast<double>(iterations);
+}
+
+inline void print_row(const std::string& name, size_t count, double us)
+{
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(10)
+              << count << std::setw(14) << std::fixed << std::setprecision(2) << us
+              << " us\n";
+}
+
+// Keeps the optimizer from discarding a result we never read
+template <typename T> void do_not_optimize(const T& value)
+{
+    [[maybe_unused]] static volatile T sink{};
+    sink = value;
+}
+
+// One function per benchmark, BenchMain.cpp runs them all
+void run_ball_batch();
+void run_snapshot();
+void run_queue();
+void run_particles();
+void run_level_collisions();
+void run_level_reset();
+void run_resources();
+} // namespace bench
@@ -0,0 +1,13 @@
+#include "Bench.h"
+
+int main()
+{
+    bench::run_ball_batch();
+    bench::run_snapshot();
+    bench::run_queue();
+    bench::run_particles();
+    bench::run_level_collisions();
+    bench::run_level_reset();
+    bench::run_resources();
+    return 0;
+}
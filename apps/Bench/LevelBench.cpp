@@ -0,0 +1,125 @@
+#include <GameCommon/Types.h>
+#include <GameCommon/TileGrid.h>
+#include <GameCommon/Collision.h>
+#include "Bench.h"
+
+#include <random>
+
+// Compares finding the bricks a ball hits by testing every brick of the level,
+// the way Game::do_collisions() used to, with asking gcom::TileGrid for the
+// bricks near the ball first. Levels are synthetic, square and mostly filled.
+// The bricks here are much smaller than GameObjects, so the full scan is, if
+// anything, faster than it would be in the game.
+
+namespace
+{
+constexpr glm::vec2 TILE_SIZE{ 32.0f, 16.0f };
+constexpr float BALL_RADIUS{ 12.5f };
+constexpr u32 BALLS{ 64 }; // ball positions tested per iteration
+
+struct Brick
+{
+    glm::vec2 pos;
+    glm::vec2 size;
+    bool destroyed;
+};
+
+// Same test as Game::check_collision(BallObject, GameObject)
+bool check_collision(const glm::vec2& ball, const Brick& brick)
+{
+    const glm::vec2 center{ ball + BALL_RADIUS };
+    return std::get<0>(
+        gcom::check_collision(center, BALL_RADIUS, brick.pos, brick.size));
+}
+
+void run(u32 tiles, u32 iterations)
+{
+    std::mt19937 rng{ 1234 };
+    std::uniform_int_distribution<u32> tile_code{ 0, 5 };
+
+    std::vector<Brick> bricks{};
+    gcom::TileGrid grid{ tiles, tiles, TILE_SIZE };
+    for (u32 y{ 0 }; y < tiles; ++y)
+    {
+        for (u32 x{ 0 }; x < tiles; ++x)
+        {
+            if (tile_code(rng) > 0)
+            {
+                grid.set(x, y, static_cast<u32>(bricks.size()));
+                const glm::vec2 pos{ TILE_SIZE.x * x, TILE_SIZE.y * y };
+                bricks.push_back(Brick{ pos, TILE_SIZE, false });
+            }
+        }
+    }
+
+    const glm::vec2 level_size{ TILE_SIZE * static_cast<float>(tiles) };
+    std::uniform_real_distribution<float> x{ 0.0f, level_size.x };
+    std::uniform_real_distribution<float> y{ 0.0f, level_size.y };
+    std::vector<glm::vec2> balls(BALLS);
+    for (glm::vec2& ball : balls)
+    {
+        ball = glm::vec2{ x(rng), y(rng) };
+    }
+
+    u32 scan_hits{ 0 };
+    const double scan_us{ bench::time_us(
+        iterations,
+        [&]()
+        {
+            scan_hits = 0;
+            for (const glm::vec2& ball : balls)
+            {
+                for (const Brick& brick : bricks)
+                {
+                    if (!brick.destroyed && check_collision(ball, brick))
+                    {
+                        ++scan_hits;
+                    }
+                }
+            }
+            bench::do_not_optimize(scan_hits);
+        }) };
+
+    const glm::vec2 radius{ BALL_RADIUS };
+    u32 grid_hits{ 0 };
+    std::vector<u32> nearby{};
+    const double grid_us{ bench::time_us(
+        iterations * 1000,
+        [&]()
+        {
+            grid_hits = 0;
+            for (const glm::vec2& ball : balls)
+            {
+                // the bounds Game::collision_bounds() gives
+                grid.query(ball - radius, ball + 3.0f * radius, nearby);
+                for (const u32 index : nearby)
+                {
+                    const Brick& brick{ bricks[index] };
+                    if (!brick.destroyed && check_collision(ball, brick))
+                    {
+                        ++grid_hits;
+                    }
+                }
+            }
+            bench::do_not_optimize(grid_hits);
+        }) };
+
+    if (scan_hits != grid_hits)
+    {
+        std::cout << "MISMATCH: scan found " << scan_hits << " hits, grid "
+                  << grid_hits << "\n";
+    }
+
+    const std::string level{ std::to_string(tiles) + "x" + std::to_string(tiles) };
+    bench::print_row(level + " scan", bricks.size(), scan_us / BALLS);
+    bench::print_row(level + " grid", bricks.size(), grid_us / BALLS);
+    std::cout << "speedup: " << std::setprecision(0) << scan_us / grid_us << "x\n\n";
+}
+} // namespace
+
+void bench::run_level_collisions()
+{
+    std::cout << "Ball vs bricks, average time per ball, count is bricks\n\n";
+    run(256, 10);
+    run(1024, 1);
+}
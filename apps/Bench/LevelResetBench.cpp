@@ -0,0 +1,96 @@
+#include <GameCommon/Types.h>
+#include <GameCommon/LevelTemplate.h>
+#include "Bench.h"
+
+// Compares restarting the game's levels the way Game::reset_level() used to, by
+// reading the level file and laying the bricks out again, with
+// GameLevel::reset(), which keeps the layout and only brings the bricks back.
+// Reads res/levels, so run it from the repository root. The bricks here leave
+// out the texture a GameObject carries, which the old way also looked up.
+
+namespace
+{
+constexpr std::array<std::string_view, 4> LEVELS{ "res/levels/one.lvl",
+                                                  "res/levels/two.lvl",
+                                                  "res/levels/three.lvl",
+                                                  "res/levels/four.lvl" };
+constexpr u32 LEVEL_WIDTH{ 800 };
+constexpr u32 LEVEL_HEIGHT{ 300 };
+
+struct Brick
+{
+    gcom::LevelTemplate::Brick layout;
+    bool destroyed;
+};
+
+void build(const gcom::LevelTemplate& level, std::vector<Brick>& bricks)
+{
+    bricks.clear();
+    for (const gcom::LevelTemplate::Brick& brick : level.bricks())
+    {
+        bricks.push_back(Brick{ brick, false });
+    }
+}
+
+void destroy_half(std::vector<Brick>& bricks)
+{
+    for (size_t i{ 0 }; i < bricks.size(); i += 2)
+    {
+        bricks[i].destroyed = true;
+    }
+}
+} // namespace
+
+void bench::run_level_reset()
+{
+    std::cout << "Level reset, average time per level, count is bricks\n\n";
+
+    for (const std::string_view file : LEVELS)
+    {
+        const std::vector<std::vector<u32>> tiles{ gcom::LevelTemplate::read_tiles(
+            file) };
+        if (tiles.empty())
+        {
+            std::cout << "Skipping " << file << ", run from the repository root\n\n";
+            continue;
+        }
+        const gcom::LevelTemplate level{ tiles, LEVEL_WIDTH, LEVEL_HEIGHT };
+
+        std::vector<Brick> bricks{};
+        build(level, bricks);
+        if (bricks.empty())
+        {
+            continue; // nothing to reset, the row would only time the loop
+        }
+
+        const double reload_us{ bench::time_us(
+            1000,
+            [&]()
+            {
+                destroy_half(bricks);
+                const gcom::LevelTemplate reloaded{
+                    gcom::LevelTemplate::read_tiles(file), LEVEL_WIDTH, LEVEL_HEIGHT
+                };
+                build(reloaded, bricks);
+                bench::do_not_optimize(bricks.size());
+            }) };
+
+        const double reset_us{ bench::time_us(
+            100000,
+            [&]()
+            {
+                destroy_half(bricks);
+                for (Brick& brick : bricks)
+                {
+                    brick.destroyed = false;
+                }
+                bench::do_not_optimize(bricks.size());
+            }) };
+
+        const std::string name{ file.substr(file.rfind('/') + 1) };
+        bench::print_row(name + " reload", bricks.size(), reload_us);
+        bench::print_row(name + " reset", bricks.size(), reset_us);
+        std::cout << "speedup: " << std::setprecision(0) << reload_us / reset_us
+                  << "x\n\n";
+    }
+}
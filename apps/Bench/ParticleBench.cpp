@@ -0,0 +1,155 @@
+#include <GameCommon/Types.h>
+#include <GameCommon/ParticlePool.h>
+#include "Bench.h"
+
+#include <random>
+
+// Compares the particle update ParticleGenerator used to do, an array of Particle
+// structs with a linear scan for a free slot, with gcom::ParticlePool. Every step
+// spawns enough particles to keep the pool 90% full, like a long running emitter
+// with a one second particle life. The spawn values are drawn up front so the
+// random number generator isn't timed.
+
+namespace
+{
+constexpr float DT{ 1.0f / 120.0f };
+constexpr u32 WARM_UP_STEPS{ 240 }; // two particle lifetimes
+constexpr float LOAD{ 0.9f };
+
+struct Particle
+{
+    glm::vec2 pos{ 0.0f };
+    glm::vec2 velocity{ 0.0f };
+    glm::vec4 color{ 1.0f };
+    float life{ 0.0f };
+};
+
+// The old ParticleGenerator without the GL parts
+class StructParticles
+{
+  public:
+    explicit StructParticles(u32 amount) : particles_(amount) {}
+
+    void spawn(const glm::vec2& pos, const glm::vec2& velocity, float shade)
+    {
+        Particle& particle{ particles_[first_unused_particle()] };
+        particle.pos      = pos;
+        particle.color    = glm::vec4{ shade, shade, shade, 1.0f };
+        particle.life     = 1.0f;
+        particle.velocity = velocity;
+    }
+
+    void update(float dt)
+    {
+        for (Particle& p : particles_)
+        {
+            p.life -= dt;
+            if (p.life > 0.0f)
+            {
+                p.pos -= p.velocity * dt;
+                p.color.a -= dt * 2.5f;
+            }
+        }
+    }
+
+    const Particle& front() const { return particles_.front(); }
+
+  private:
+    std::vector<Particle> particles_;
+    u32 last_used_particle_{ 0 };
+
+    u32 first_unused_particle()
+    {
+        const auto amount{ static_cast<u32>(particles_.size()) };
+        for (u32 i{ last_used_particle_ }; i < amount; ++i)
+        {
+            if (particles_[i].life <= 0.0f)
+            {
+                last_used_particle_ = i;
+                return i;
+            }
+        }
+        for (u32 i{ 0 }; i < last_used_particle_; ++i)
+        {
+            if (particles_[i].life <= 0.0f)
+            {
+                last_used_particle_ = i;
+                return i;
+            }
+        }
+        last_used_particle_ = 0;
+        return 0;
+    }
+};
+
+void run(u32 amount, u32 iterations)
+{
+    // a new batch of particles every step replaces the batch that just died
+    const auto per_step{ static_cast<u32>(amount * DT * LOAD) };
+
+    std::mt19937 rng{ 1234 };
+    std::uniform_real_distribution<float> pos{ 0.0f, 800.0f };
+    std::uniform_real_distribution<float> velocity{ -40.0f, 40.0f };
+    std::uniform_real_distribution<float> shade{ 0.5f, 1.5f };
+
+    struct Spawn
+    {
+        glm::vec2 pos;
+        glm::vec2 velocity;
+        float shade;
+    };
+    std::vector<Spawn> spawns(per_step);
+    for (Spawn& spawn : spawns)
+    {
+        spawn = Spawn{ glm::vec2{ pos(rng), pos(rng) },
+                       glm::vec2{ velocity(rng), velocity(rng) },
+                       shade(rng) };
+    }
+
+    StructParticles structs{ amount };
+    gcom::ParticlePool pool{ amount };
+
+    const auto step = [&](auto& particles)
+    {
+        for (const Spawn& spawn : spawns)
+        {
+            particles.spawn(spawn.pos, spawn.velocity, spawn.shade);
+        }
+        particles.update(DT);
+    };
+
+    for (u32 i{ 0 }; i < WARM_UP_STEPS; ++i)
+    {
+        step(structs);
+        step(pool);
+    }
+
+    const double structs_us{ bench::time_us(iterations,
+                                            [&]()
+                                            {
+                                                step(structs);
+                                                bench::do_not_optimize(
+                                                    structs.front().life);
+                                            }) };
+    const double pool_us{ bench::time_us(iterations,
+                                         [&]()
+                                         {
+                                             step(pool);
+                                             bench::do_not_optimize(pool.size());
+                                         }) };
+
+    bench::print_row("particle structs", amount, structs_us);
+    bench::print_row("particle pool", amount, pool_us);
+    std::cout << "live: " << pool.size() << ", speedup: " << std::setprecision(2)
+              << structs_us / pool_us << "x\n\n";
+}
+} // namespace
+
+void bench::run_particles()
+{
+    std::cout << "Particle update, average time per step with spawning, count is "
+                 "capacity\n\n";
+    run(10'000, 500);
+    run(100'000, 100);
+    run(1'000'000, 10);
+}
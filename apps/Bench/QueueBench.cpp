@@ -0,0 +1,151 @@
+#include <GameCommon/Types.h>
+#include <GameCommon/MpscQueue.h>
+#include <NetCommon/NetCommon.h>
+#include "Bench.h"
+
+// Feeds one consumer from two producer threads, the way the router and UDP
+// threads feed a shard, once through net::tsqueue and once through
+// gcom::MpscQueue. Paced at 1M messages per second it reports how long a message
+// waits in the queue, unpaced it reports the throughput.
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr u32 PRODUCERS{ 2 };
+constexpr u64 PACED_RATE{ 1'000'000 }; // messages per second, all producers
+constexpr u64 MESSAGES{ 1'000'000 };
+constexpr size_t CAPACITY{ 16384 };
+
+// About the size of a small game message
+struct Item
+{
+    Clock::time_point sent{};
+    std::array<u8, 24> body{};
+};
+
+struct Result
+{
+    double seconds{ 0.0 };
+    double mean_latency_us{ 0.0 };
+    double max_latency_us{ 0.0 };
+};
+
+// push(Item&&) runs on the producer threads, drain(fn) on the calling thread and
+// calls fn(Item&) for every message it takes. A rate of 0 sends unpaced.
+template <typename Push, typename Drain>
+Result run(Push&& push, Drain&& drain, u64 rate)
+{
+    const u64 per_producer{ MESSAGES / PRODUCERS };
+    const std::chrono::duration<double> seconds_per_message{
+        rate == 0 ? 0.0 : static_cast<double>(PRODUCERS) / rate
+    };
+    const auto interval{ std::chrono::duration_cast<Clock::duration>(
+        seconds_per_message) };
+
+    const auto start{ Clock::now() };
+    std::vector<std::thread> producers{};
+    for (u32 p{ 0 }; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back(
+            [&, start]()
+            {
+                for (u64 i{ 0 }; i < per_producer; ++i)
+                {
+                    const auto due{ start + interval * static_cast<i64>(i) };
+                    while (Clock::now() < due)
+                    {
+                    }
+                    push(Item{ Clock::now(), {} });
+                }
+            });
+    }
+
+    u64 received{ 0 };
+    double total_latency_us{ 0.0 };
+    double max_latency_us{ 0.0 };
+    while (received < per_producer * PRODUCERS)
+    {
+        const size_t count{ drain(
+            [&](Item& item)
+            {
+                const std::chrono::duration<double, std::micro> waited{
+                    Clock::now() - item.sent
+                };
+                const double latency_us{ waited.count() };
+                total_latency_us += latency_us;
+                max_latency_us = std::max(max_latency_us, latency_us);
+                bench::do_not_optimize(item.body[0]);
+            }) };
+        received += count;
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    const auto end{ Clock::now() };
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    return Result{ std::chrono::duration<double>{ end - start }.count(),
+                   total_latency_us / static_cast<double>(received),
+                   max_latency_us };
+}
+
+Result run_tsqueue(u64 rate)
+{
+    net::tsqueue<Item> queue{};
+    return run([&](Item&& item) { queue.push_back(std::move(item)); },
+               [&](auto&& fn)
+               {
+                   size_t count{ 0 };
+                   while (!queue.empty())
+                   {
+                       Item item{ queue.pop_front() };
+                       fn(item);
+                       ++count;
+                   }
+                   return count;
+               },
+               rate);
+}
+
+Result run_mpsc_queue(u64 rate)
+{
+    gcom::MpscQueue<Item> queue{ CAPACITY };
+    return run(
+        [&](Item&& item)
+        {
+            while (!queue.try_push(std::move(item)))
+            {
+                std::this_thread::yield();
+            }
+        },
+        [&](auto&& fn) { return queue.drain(fn, CAPACITY); },
+        rate);
+}
+} // namespace
+
+void bench::run_queue()
+{
+    std::cout << "Shard inbox, " << PRODUCERS << " producers, " << MESSAGES
+              << " messages\n\n";
+
+    const auto print = [](const std::string& name, const Result& result)
+    {
+        std::cout << std::left << std::setw(28) << name << std::right
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << MESSAGES / result.seconds / 1e6 << " M msgs/s" << std::setw(10)
+                  << result.mean_latency_us << " us mean" << std::setw(12)
+                  << result.max_latency_us << " us max\n";
+    };
+
+    print("tsqueue, 1M msgs/s", run_tsqueue(PACED_RATE));
+    print("MpscQueue, 1M msgs/s", run_mpsc_queue(PACED_RATE));
+    print("tsqueue, unpaced", run_tsqueue(0));
+    print("MpscQueue, unpaced", run_mpsc_queue(0));
+    std::cout << '\n';
+}
@@ -0,0 +1,98 @@
+#include <GameCommon/Types.h>
+#include <GameCommon/ResourceRegistry.h>
+#include "Bench.h"
+
+#include <random>
+
+// Compares getting textures the way ResourceManager used to, a copy out of a
+// std::map keyed by name, with getting them through a handle of
+// gcom::ResourceRegistry. The names are the client's textures and the lookups
+// are a random mix of them. The stand-in texture has the size of a Texture2D
+// but needs no GL context.
+
+namespace
+{
+constexpr u32 LOOKUPS{ 4096 }; // per iteration
+
+struct FakeTexture
+{
+    u32 id{ 0 };
+    std::array<u32, 8> state{}; // size, formats, wrap and filter modes
+};
+
+constexpr std::array<std::string_view, 13> NAMES{ "ball",
+                                                   "background",
+                                                   "block",
+                                                   "indestructible_block",
+                                                   "paddle",
+                                                   "particle",
+                                                   "powerup_speed",
+                                                   "powerup_sticky",
+                                                   "powerup_increase",
+                                                   "powerup_confuse",
+                                                   "powerup_chaos",
+                                                   "powerup_passthrough",
+                                                   "face" };
+} // namespace
+
+void bench::run_resources()
+{
+    std::map<std::string_view, FakeTexture> map{};
+    gcom::ResourceRegistry<FakeTexture> registry{};
+    for (size_t i{ 0 }; i < NAMES.size(); ++i)
+    {
+        const FakeTexture texture{ static_cast<u32>(i + 1) };
+        map[NAMES[i]] = texture;
+        registry.set(NAMES[i], texture);
+    }
+
+    // names and handles resolved up front, like the game does at load time
+    std::mt19937 rng{ 1234 };
+    std::uniform_int_distribution<size_t> pick{ 0, NAMES.size() - 1 };
+    std::vector<std::string_view> names(LOOKUPS);
+    std::vector<gcom::Handle<FakeTexture>> handles(LOOKUPS);
+    for (u32 i{ 0 }; i < LOOKUPS; ++i)
+    {
+        names[i]   = NAMES[pick(rng)];
+        handles[i] = registry.intern(names[i]);
+    }
+
+    u64 map_sum{ 0 };
+    const double map_us{ bench::time_us(
+        1000,
+        [&]()
+        {
+            map_sum = 0;
+            for (const std::string_view name : names)
+            {
+                const FakeTexture texture{ map[name] };
+                map_sum += texture.id;
+            }
+            bench::do_not_optimize(map_sum);
+        }) };
+
+    u64 handle_sum{ 0 };
+    const double handle_us{ bench::time_us(
+        1000,
+        [&]()
+        {
+            handle_sum = 0;
+            for (const gcom::Handle<FakeTexture> handle : handles)
+            {
+                handle_sum += registry.get(handle).id;
+            }
+            bench::do_not_optimize(handle_sum);
+        }) };
+
+    if (map_sum != handle_sum)
+    {
+        std::cout << "MISMATCH: map found " << map_sum << ", handles "
+                  << handle_sum << "\n";
+    }
+
+    std::cout << "Texture lookups, average time for all, count is lookups\n\n";
+    bench::print_row("std::map by name", LOOKUPS, map_us);
+    bench::print_row("registry by handle", LOOKUPS, handle_us);
+    std::cout << "speedup: " << std::setprecision(0) << map_us / handle_us
+              << "x\n\n";
+}
@@ -0,0 +1,239 @@
+#include <GameCommon/Types.h>
+#include <GameCommon/BallBatch.h>
+#include <GameCommon/BallDesc.h>
+#include <GameCommon/PlayerDesc.h>
+#include <GameCommon/Snapshot.h>
+#include <GameCommon/InputCommand.h>
+#include "Bench.h"
+
+// Plays a scripted match and counts the bytes both protocols put on the wire for
+// it: the old full PlayerDesc/BallDesc messages and the delta-compressed
+// gcom::Snapshot stream. Nothing is sent, only the message sizes are added up.
+
+namespace
+{
+constexpr glm::vec2 BOUNDS{ 800.0f, 600.0f };
+constexpr glm::vec2 PADDLE_SIZE{ 100.0f, 20.0f };
+constexpr float BALL_RADIUS{ 12.5f };
+constexpr u32 TICK_RATE{ 60 };
+constexpr float DT{ 1.0f / TICK_RATE };
+constexpr u32 TICKS{ TICK_RATE * 60 };
+
+// net::MessageHeader is the message id and the body size
+constexpr size_t MSG_HEADER_BYTES{ sizeof(u32) + sizeof(u32) };
+// Acks take a round trip before the sender can act on them
+constexpr u32 ACK_DELAY_TICKS{ 6 };
+constexpr u32 INPUT_RESEND_TICKS{ TICK_RATE / 10 };
+constexpr u16 ACK_INTERVAL{ 4 };
+
+struct ByteCount
+{
+    size_t down{ 0 }; // server -> clients
+    size_t up{ 0 };   // clients -> server
+
+    size_t total() const { return down + up; }
+};
+
+// Paddles chase the ball but only one of them at a time, the other one waits
+glm::vec2 follow(const glm::vec2& paddle, const BallDesc& ball, bool chasing)
+{
+    if (!chasing)
+    {
+        return paddle;
+    }
+
+    const float target{ ball.pos.x + ball.radius - PADDLE_SIZE.x / 2.0f };
+    const float step{ std::clamp(target - paddle.x, -gcom::PADDLE_SPEED * DT,
+                                 gcom::PADDLE_SPEED * DT) };
+    return glm::vec2{ std::clamp(paddle.x + step, 0.0f, BOUNDS.x - PADDLE_SIZE.x),
+                      paddle.y };
+}
+} // namespace
+
+void bench::run_snapshot()
+{
+    std::cout << "Match state bandwidth, one " << TICKS / TICK_RATE
+              << " s match at " << TICK_RATE << " Hz\n\n";
+
+    gcom::BallBatch balls{};
+    const BallDesc start{ BALL_RADIUS,
+                          false,
+                          glm::vec2{ 300.0f, 300.0f },
+                          glm::vec2{ 100.0f, -350.0f },
+                          glm::vec2{ BALL_RADIUS * 2.0f, BALL_RADIUS * 2.0f } };
+    const gcom::BallBatch::Slot slot{ balls.add(start, BOUNDS) };
+    balls.set_active(slot, true);
+
+    std::array<glm::vec2, 2> paddles{
+        glm::vec2{ BOUNDS.x / 2.0f - PADDLE_SIZE.x / 2.0f, BOUNDS.y - PADDLE_SIZE.y },
+        glm::vec2{ BOUNDS.x / 2.0f - PADDLE_SIZE.x / 2.0f, 0.0f }
+    };
+    std::array<u32, 2> lives{ 3, 3 };
+
+    ByteCount legacy{};
+    ByteCount snapshot_bytes{};
+
+    gcom::SnapshotHistory sent{};
+    std::array<gcom::SnapshotHistory, 2> received{};
+    std::deque<std::pair<u32, u16>> acks_in_flight{}; // arrival tick, sequence
+    std::optional<u16> acked{};
+    std::vector<u8> encoded{};
+
+    // Client inputs waiting for an ack, and when the last ones were sent
+    std::array<std::deque<gcom::InputCommand>, 2> pending_inputs{};
+    std::array<std::deque<std::pair<u32, u32>>, 2> input_acks_in_flight{};
+    std::array<u32, 2> next_input{ 1, 1 };
+    std::array<u32, 2> last_input_send{};
+
+    for (u32 tick{ 0 }; tick < TICKS; ++tick)
+    {
+        // Clients move their paddles
+        const BallDesc ball_before{ balls.get(slot) };
+        const bool ball_going_down{ ball_before.velocity.y > 0.0f };
+        for (u32 paddle{ 0 }; paddle < paddles.size(); ++paddle)
+        {
+            const glm::vec2 before{ paddles[paddle] };
+            paddles[paddle] =
+                follow(paddles[paddle], ball_before, ball_going_down == (paddle == 0));
+            balls.set_paddle(slot, paddle, paddles[paddle], PADDLE_SIZE);
+
+            // Old protocol: a full PlayerDesc every frame, bounced to the other
+            // client
+            legacy.up += MSG_HEADER_BYTES + sizeof(PlayerDesc);
+            legacy.down += MSG_HEADER_BYTES + sizeof(PlayerDesc);
+
+            // New protocol: an input command when it moved, sent together with
+            // the ones not acked yet
+            auto& pending{ pending_inputs[paddle] };
+            auto& in_flight{ input_acks_in_flight[paddle] };
+            while (!in_flight.empty() && in_flight.front().first <= tick)
+            {
+                while (!pending.empty() &&
+                       pending.front().sequence <= in_flight.front().second)
+                {
+                    pending.pop_front();
+                }
+                in_flight.pop_front();
+            }
+
+            const bool moved{ before != paddles[paddle] };
+            if (moved)
+            {
+                pending.push_back(gcom::InputCommand{
+                    next_input[paddle]++,
+                    static_cast<u16>(tick),
+                    static_cast<i8>(paddles[paddle].x < before.x ? -1 : 1),
+                    static_cast<u8>(DT * 1000.0f) });
+            }
+            if (!pending.empty() &&
+                (moved || tick - last_input_send[paddle] >= INPUT_RESEND_TICKS))
+            {
+                const std::vector<gcom::InputCommand> commands(pending.begin(),
+                                                               pending.end());
+                encoded.clear();
+                gcom::encode_inputs(commands, encoded);
+                snapshot_bytes.up += MSG_HEADER_BYTES + encoded.size() + sizeof(u16);
+                last_input_send[paddle] = tick;
+                in_flight.emplace_back(tick + ACK_DELAY_TICKS,
+                                       commands.back().sequence);
+            }
+        }
+
+        // Step the ball, bounce it off the paddles and take lives at the edges
+        balls.integrate(DT);
+        balls.collide_paddles();
+        BallDesc ball{ balls.get(slot) };
+        const bool pad_hit{ balls.hit_mask(slot) != 0 };
+        if (pad_hit)
+        {
+            ball.velocity.y = ball.pos.y > BOUNDS.y / 2.0f ? -std::abs(ball.velocity.y)
+                                                           : std::abs(ball.velocity.y);
+            balls.set_velocity(slot, ball.velocity);
+        }
+        std::vector<u32> lives_lost{};
+        if (ball.pos.y >= BOUNDS.y - ball.size.y)
+        {
+            lives_lost.push_back(0);
+        }
+        else if (ball.pos.y <= 0.0f)
+        {
+            lives_lost.push_back(1);
+        }
+        for (const u32 paddle : lives_lost)
+        {
+            lives[paddle] = lives[paddle] > 1 ? lives[paddle] - 1 : 3;
+        }
+
+        // Old protocol: every client gets the ball, each lost life and the pad sound
+        for (u32 client{ 0 }; client < 2; ++client)
+        {
+            legacy.down += MSG_HEADER_BYTES + sizeof(BallDesc);
+            legacy.down += lives_lost.size() * (MSG_HEADER_BYTES + sizeof(PlayerDesc));
+            legacy.down += pad_hit ? MSG_HEADER_BYTES : 0;
+        }
+
+        // New protocol: one snapshot per client against the last acked one
+        while (!acks_in_flight.empty() && acks_in_flight.front().first <= tick)
+        {
+            acked = acks_in_flight.front().second;
+            acks_in_flight.pop_front();
+        }
+
+        gcom::Snapshot snapshot{};
+        snapshot.sequence = static_cast<u16>(tick);
+        snapshot.fields[gcom::Snapshot::SERVER_TIME_MS] =
+            static_cast<i32>(tick * 1000 / TICK_RATE);
+        snapshot.events   = pad_hit ? gcom::Snapshot::EVENT_PAD_HIT : 0;
+        snapshot.set_ball(ball);
+        for (u32 paddle{ 0 }; paddle < paddles.size(); ++paddle)
+        {
+            snapshot.set_paddle(paddle, paddles[paddle], lives[paddle]);
+        }
+
+        for (u32 client{ 0 }; client < 2; ++client)
+        {
+            snapshot.input_ack = next_input[client] - 1;
+            encoded.clear();
+            gcom::encode_snapshot(
+                snapshot, acked ? sent.find(*acked) : nullptr, encoded);
+            // the bytes plus their u16 count, see SnapshotMsg.h
+            snapshot_bytes.down += MSG_HEADER_BYTES + encoded.size() + sizeof(u16);
+
+            // Check the client can actually decode it
+            std::optional<gcom::Snapshot> decoded{ gcom::decode_snapshot(
+                encoded, received[client]) };
+            if (!decoded || decoded->fields != snapshot.fields)
+            {
+                std::cout << "snapshot " << tick << " did not round trip\n";
+                return;
+            }
+            received[client].store(*decoded);
+
+            if (snapshot.sequence % ACK_INTERVAL == 0)
+            {
+                snapshot_bytes.up += MSG_HEADER_BYTES + sizeof(u16);
+            }
+        }
+        if (snapshot.sequence % ACK_INTERVAL == 0)
+        {
+            acks_in_flight.emplace_back(tick + ACK_DELAY_TICKS, snapshot.sequence);
+        }
+        sent.store(snapshot);
+    }
+
+    const auto print = [](const std::string& name, const ByteCount& bytes)
+    {
+        const double seconds{ static_cast<double>(TICKS) / TICK_RATE };
+        std::cout << std::left << std::setw(28) << name << std::right << std::setw(10)
+                  << bytes.down / seconds << " B/s down" << std::setw(10)
+                  << bytes.up / seconds << " B/s up" << std::setw(10)
+                  << static_cast<double>(bytes.total()) / TICKS << " B/tick\n";
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    print("full descs", legacy);
+    print("delta snapshots", snapshot_bytes);
+    std::cout << "reduction: " << std::setprecision(2)
+              << static_cast<double>(legacy.total()) / snapshot_bytes.total()
+              << "x\n\n";
+}
@@ -0,0 +1,390 @@
+#include <GameCommon/Common.h>
+#include <GameCommon/Shader.h>
+#include <GameCommon/Texture.h>
+#include <GameCommon/SpriteRenderer.h>
+#include <GameCommon/SpriteBatch.h>
+#include <GameCommon/ParticleGenerator.h>
+#include <GameCommon/GLCounters.h>
+#include <GameCommon/UniformBuffer.h>
+#include "Bench.h"
+
+// Draws a frame of bricks, paddles, power-ups and a ball through
+// gcom::SpriteRenderer, one draw call per sprite, and through gcom::SpriteBatch,
+// then checks both produced the same pixels and times them. Needs an OpenGL 3.3
+// context but no visible window, so it also runs headless, e.g.
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./SpriteBench
+// from the repository root, where res/shaders is. Exits with 1 when the images
+// differ. It also counts the uniform uploads of the one-call-per-sprite path with
+// and without cached uniform handles. Last it times gcom::ParticleGenerator,
+// which draws all its live particles with one instanced call, at budgets of up
+// to 100k particles.
+
+namespace
+{
+constexpr u32 WIDTH{ 800 };
+constexpr u32 HEIGHT{ 600 };
+constexpr u32 FRAMES{ 60 };
+// Colors may differ by rounding between the two shaders, nothing more
+constexpr int MAX_CHANNEL_DIFF{ 2 };
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream file{ path };
+    std::stringstream stream{};
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+void fill_texture(gcom::Texture2D& texture, u8 seed)
+{
+    std::array<u8, 16 * 16 * 3> pixels{};
+    for (size_t i{ 0 }; i < 16 * 16; ++i)
+    {
+        pixels[i * 3]     = static_cast<u8>(i * 7 + seed * 80);
+        pixels[i * 3 + 1] = static_cast<u8>(i * 13);
+        pixels[i * 3 + 2] = static_cast<u8>(seed * 50);
+    }
+    texture.generate(16, 16, pixels.data());
+}
+
+struct Sprite
+{
+    const gcom::Texture2D* texture;
+    glm::vec2 pos;
+    glm::vec2 size;
+    float rotate;
+    glm::vec3 color;
+    u32 layer;
+};
+
+// A full level of bricks, the paddles, a few falling power-ups and the ball.
+// `copies` repeats the bricks to see how both paths scale.
+std::vector<Sprite> make_scene(const std::vector<gcom::Texture2D>& textures,
+                               u32 copies)
+{
+    std::vector<Sprite> sprites{};
+    sprites.push_back(Sprite{ &textures[0],
+                              glm::vec2{ 0.0f, 0.0f },
+                              glm::vec2{ WIDTH, HEIGHT },
+                              0.0f,
+                              glm::vec3{ 1.0f },
+                              0 });
+
+    constexpr u32 COLUMNS{ 15 };
+    constexpr u32 ROWS{ 8 };
+    const glm::vec2 brick{ static_cast<float>(WIDTH) / COLUMNS, 20.0f };
+    for (u32 copy{ 0 }; copy < copies; ++copy)
+    {
+        for (u32 y{ 0 }; y < ROWS; ++y)
+        {
+            for (u32 x{ 0 }; x < COLUMNS; ++x)
+            {
+                const bool solid{ (x + y) % 5 == 0 };
+                sprites.push_back(
+                    Sprite{ &textures[solid ? 2 : 1],
+                            glm::vec2{ x * brick.x, 100.0f + y * brick.y },
+                            brick,
+                            0.0f,
+                            glm::vec3{ 0.2f + 0.05f * x, 0.6f, 0.3f + 0.08f * y },
+                            1 });
+            }
+        }
+    }
+
+    for (u32 paddle{ 0 }; paddle < 2; ++paddle)
+    {
+        sprites.push_back(Sprite{ &textures[3],
+                                  glm::vec2{ 350.0f, paddle == 0 ? HEIGHT - 20.0f
+                                                                 : 0.0f },
+                                  glm::vec2{ 100.0f, 20.0f },
+                                  0.0f,
+                                  glm::vec3{ 1.0f },
+                                  1 });
+    }
+    for (u32 powerup{ 0 }; powerup < 6; ++powerup)
+    {
+        sprites.push_back(Sprite{ &textures[4],
+                                  glm::vec2{ 60.0f + powerup * 120.0f, 400.0f },
+                                  glm::vec2{ 60.0f, 20.0f },
+                                  powerup * 15.0f,
+                                  glm::vec3{ 1.0f, 0.5f + powerup * 0.1f, 0.5f },
+                                  1 });
+    }
+    sprites.push_back(Sprite{ &textures[5],
+                              glm::vec2{ 300.0f, 300.0f },
+                              glm::vec2{ 25.0f, 25.0f },
+                              0.0f,
+                              glm::vec3{ 1.0f },
+                              2 });
+    return sprites;
+}
+
+std::vector<u8> read_pixels()
+{
+    std::vector<u8> pixels(WIDTH * HEIGHT * 4);
+    glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+} // namespace
+
+int main()
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window{
+        glfwCreateWindow(WIDTH, HEIGHT, "SpriteBench", nullptr, nullptr)
+    };
+    if (!window)
+    {
+        std::cerr << "Failed to create an OpenGL context\n";
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cerr << "Failed to initialize GLAD\n";
+        return 1;
+    }
+    std::cout << "Sprite drawing on " << glGetString(GL_RENDERER) << "\n\n";
+
+    // Hidden windows may not have a usable default framebuffer
+    u32 framebuffer{};
+    u32 color_buffer{};
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &color_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glFramebufferRenderbuffer(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_buffer);
+
+    glViewport(0, 0, WIDTH, HEIGHT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // every shader reads its projection from the View block
+    gcom::ViewUniforms view{};
+    view.projection = glm::ortho(0.0f,
+                                 static_cast<float>(WIDTH),
+                                 static_cast<float>(HEIGHT),
+                                 0.0f,
+                                 -1.0f,
+                                 1.0f);
+    auto view_uniforms{ std::make_unique<gcom::UniformBuffer>(
+        gcom::UniformBlock::View, sizeof(gcom::ViewUniforms)) };
+    view_uniforms->update(view);
+
+    gcom::Shader sprite_shader{};
+    sprite_shader.compile(read_file("res/shaders/sprite.vert"),
+                          read_file("res/shaders/sprite.frag"));
+    sprite_shader.use().set_integer("image", 0);
+    gcom::Shader batch_shader{};
+    batch_shader.compile(read_file("res/shaders/sprite_batch.vert"),
+                         read_file("res/shaders/sprite_batch.frag"));
+    batch_shader.use().set_integer("image", 0);
+
+    // background, brick, solid brick, paddle, power-up, ball
+    std::vector<gcom::Texture2D> textures(6);
+    for (size_t i{ 0 }; i < textures.size(); ++i)
+    {
+        fill_texture(textures[i], static_cast<u8>(i));
+    }
+
+    bool images_match{ true };
+    {
+        gcom::SpriteRenderer renderer{ sprite_shader };
+        gcom::SpriteBatch batch{ batch_shader };
+
+        std::cout << std::left << std::setw(28) << "scene" << std::right
+                  << std::setw(10) << "sprites" << std::setw(14) << "draw calls"
+                  << std::setw(14) << "cpu ms" << std::setw(14) << "frame ms"
+                  << '\n';
+        for (const u32 copies : { 1u, 10u, 100u })
+        {
+            const std::vector<Sprite> scene{ make_scene(textures, copies) };
+
+            const auto draw_one_by_one = [&]()
+            {
+                for (const Sprite& sprite : scene)
+                {
+                    renderer.draw_sprite(*sprite.texture,
+                                         sprite.pos,
+                                         sprite.size,
+                                         sprite.rotate,
+                                         sprite.color);
+                }
+            };
+            const auto draw_batched = [&]()
+            {
+                batch.begin_frame();
+                for (const Sprite& sprite : scene)
+                {
+                    batch.add(*sprite.texture,
+                              sprite.pos,
+                              sprite.size,
+                              sprite.rotate,
+                              sprite.color,
+                              sprite.layer);
+                }
+                batch.flush();
+            };
+
+            // Same picture both ways. The bricks of every copy sit on top of
+            // each other, so only the first frame is compared.
+            if (copies == 1)
+            {
+                glClear(GL_COLOR_BUFFER_BIT);
+                draw_one_by_one();
+                const std::vector<u8> expected{ read_pixels() };
+                glClear(GL_COLOR_BUFFER_BIT);
+                draw_batched();
+                const std::vector<u8> actual{ read_pixels() };
+
+                int max_diff{ 0 };
+                for (size_t i{ 0 }; i < expected.size(); ++i)
+                {
+                    max_diff = std::max(max_diff, std::abs(expected[i] - actual[i]));
+                }
+                images_match = max_diff <= MAX_CHANNEL_DIFF;
+                std::cout << "max channel difference: " << max_diff
+                          << (images_match ? "\n" : " MISMATCH\n");
+            }
+
+            // cpu ms is the time to issue the draws, frame ms waits for the GPU
+            const auto time_frames = [&](const std::string& name,
+                                         auto&& draw,
+                                         u32 draw_calls)
+            {
+                const double cpu_us{ bench::time_us(FRAMES, draw) };
+                glFinish();
+                const double frame_us{ bench::time_us(FRAMES,
+                                                      [&]()
+                                                      {
+                                                          draw();
+                                                          glFinish();
+                                                      }) };
+                std::cout << std::left << std::setw(28) << name << std::right
+                          << std::setw(10) << scene.size() << std::setw(14)
+                          << draw_calls << std::setw(14) << std::fixed
+                          << std::setprecision(3) << cpu_us / 1000.0
+                          << std::setw(14) << frame_us / 1000.0 << '\n';
+            };
+
+            const std::string bricks{ std::to_string(copies) + "x bricks" };
+            time_frames(bricks + ", one by one",
+                        draw_one_by_one,
+                        static_cast<u32>(scene.size()));
+            draw_batched();
+            time_frames(
+                bricks + ", batched", draw_batched, batch.stats().draw_calls);
+        }
+
+        // The per sprite uniforms of the 100x scene, set the way
+        // SpriteRenderer used to, looking both locations up every time, and
+        // through cached handles that also drop unchanged values
+        const std::vector<Sprite> scene{ make_scene(textures, 100) };
+        std::vector<glm::mat4> models{};
+        for (const Sprite& sprite : scene)
+        {
+            glm::mat4 model{ glm::translate(glm::mat4{ 1.0f },
+                                            glm::vec3{ sprite.pos, 0.0f }) };
+            models.push_back(glm::scale(model, glm::vec3{ sprite.size, 1.0f }));
+        }
+        const auto model{ sprite_shader.uniform<glm::mat4>("model") };
+        const auto sprite_color{ sprite_shader.uniform<glm::vec3>("sprite_color") };
+        sprite_shader.use();
+
+        const auto set_by_name = [&]()
+        {
+            for (size_t i{ 0 }; i < scene.size(); ++i)
+            {
+                const GLint model_location{ glGetUniformLocation(sprite_shader.id,
+                                                                 "model") };
+                glUniformMatrix4fv(
+                    model_location, 1, false, glm::value_ptr(models[i]));
+                const GLint color_location{ glGetUniformLocation(sprite_shader.id,
+                                                                 "sprite_color") };
+                const glm::vec3& color{ scene[i].color };
+                glUniform3f(color_location, color.x, color.y, color.z);
+            }
+        };
+        const auto set_by_handle = [&]()
+        {
+            for (size_t i{ 0 }; i < scene.size(); ++i)
+            {
+                sprite_shader.set(model, models[i]);
+                sprite_shader.set(sprite_color, scene[i].color);
+            }
+        };
+
+        std::cout << '\n'
+                  << std::left << std::setw(28) << "uniforms, 100x bricks"
+                  << std::right << std::setw(10) << "uploads" << std::setw(14)
+                  << "skipped" << std::setw(14) << "lookups" << std::setw(14)
+                  << "cpu ms" << '\n';
+        const double by_name_us{ bench::time_us(FRAMES, set_by_name) };
+        std::cout << std::left << std::setw(28) << "location per set" << std::right
+                  << std::setw(10) << scene.size() * 2 << std::setw(14) << 0
+                  << std::setw(14) << scene.size() * 2 << std::setw(14)
+                  << by_name_us / 1000.0 << '\n';
+        // the shared cache holds whatever the name loop uploaded last
+        sprite_shader.set(sprite_color, glm::vec3{ -1.0f });
+        set_by_handle();
+        gcom::gl_counters.reset();
+        set_by_handle();
+        const gcom::GLCounters frame{ gcom::gl_counters };
+        const double by_handle_us{ bench::time_us(FRAMES, set_by_handle) };
+        std::cout << std::left << std::setw(28) << "cached handles" << std::right
+                  << std::setw(10) << frame.uniform_uploads << std::setw(14)
+                  << frame.uniform_skips << std::setw(14) << frame.location_lookups
+                  << std::setw(14) << by_handle_us / 1000.0 << '\n';
+    }
+
+    gcom::Shader particle_shader{};
+    particle_shader.compile(read_file("res/shaders/particle.vert"),
+                            read_file("res/shaders/particle.frag"));
+    particle_shader.use().set_integer("sprite", 0);
+    gcom::GameObject emitter{ glm::vec2{ 400.0f, 300.0f },
+                              glm::vec2{ 25.0f, 25.0f },
+                              textures[5],
+                              glm::vec3{ 1.0f },
+                              glm::vec2{ 100.0f, -350.0f } };
+
+    std::cout << '\n'
+              << std::left << std::setw(28) << "particles" << std::right
+              << std::setw(10) << "live" << std::setw(14) << "draw calls"
+              << std::setw(14) << "update ms" << std::setw(14) << "draw ms" << '\n';
+    for (const u32 amount : { 500u, 10'000u, 100'000u })
+    {
+        gcom::ParticleGenerator particles{ particle_shader, textures[5], amount };
+        particles.update(0.0f, emitter, amount); // every particle alive
+
+        // Short steps, so none of them dies while timing
+        const double update_us{ bench::time_us(
+            FRAMES, [&]() { particles.update(0.0001f, emitter, 0); }) };
+        const double draw_us{ bench::time_us(FRAMES,
+                                             [&]()
+                                             {
+                                                 particles.draw();
+                                                 glFinish();
+                                             }) };
+        std::cout << std::left << std::setw(28) << std::to_string(amount) + " budget"
+                  << std::right << std::setw(10) << particles.live_count()
+                  << std::setw(14) << 1 << std::setw(14) << update_us / 1000.0
+                  << std::setw(14) << draw_us / 1000.0 << '\n';
+    }
+
+    view_uniforms.reset();
+    glDeleteRenderbuffers(1, &color_buffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    glfwTerminate();
+    return images_match ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <GameCommon/Common.h>
+
+// Number of operator new calls the calling thread made so far. Per thread, so the
+// network threads filling the message queues don't show up in the game loop's
+// count. GameClient.cpp only counts when built with PONGNET_COUNT_ALLOCATIONS,
+// otherwise this stays 0.
+namespace alloc_counter
+{
+inline thread_local u64 allocations{ 0 };
+
+inline u64 count() { return allocations; }
+} // namespace alloc_counter
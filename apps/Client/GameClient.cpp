@@ -1,6 +1,24 @@
 #include "OnlineGame.h"
+#include "AllocationCounter.h"
 #include <GameCommon/Common.h>
 
+#ifdef PONGNET_COUNT_ALLOCATIONS
+// Replacing the scalar forms is enough, the array forms call these
+void* operator new(std::size_t size)
+{
+    ++alloc_counter::allocations;
+    if (void* ptr{ std::malloc(size == 0 ? 1 : size) })
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
 constexpr u32 SCR_WIDTH{ 800 };
 constexpr u32 SCR_HEIGHT{ 600 };
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <GameCommon/Game.h>
+#include <GameCommon/GLCounters.h>
 #include <GameCommon/Player.h>
 #include "Client.h"
+#include "AllocationCounter.h"
 #include "GLFW/glfw3.h"
 #include "GameCommon/BallDesc.h"
 #include "GameCommon/BallObject.h"
@@ -11,11 +13,18 @@
 #include "imgui_internal.h"
 #include <GameCommon/ResourceManager.h>
 #include <GameCommon/PlayerDesc.h>
+#include <GameCommon/Snapshot.h>
+#include <GameCommon/SnapshotBuffer.h>
+#include <GameCommon/InputCommand.h>
+#include "../SnapshotMsg.h"
+#include "../UdpChannel.h"
 
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
 
+#include <iomanip>
+
 class OnlineGame : public gcom::Game
 {
 
@@ -24,6 +33,8 @@ class OnlineGame : public gcom::Game
 
     bool init() override
     {
+        init_start_ = std::chrono::steady_clock::now();
+
         // glfw: initialize and configure
         // ------------------------------
         glfwInit();
@@ -56,6 +67,10 @@ class OnlineGame : public gcom::Game
             return false;
         }
 
+        // compiled programs are kept between runs, shaders only compile after
+        // they or the driver changed
+        gcom::ProgramCache::open(PROGRAM_CACHE_DIRECTORY);
+
         glfwSetKeyCallback(window_, key_callback);
         glfwSetFramebufferSizeCallback(window_, framebuffer_size_callback);
 
@@ -65,62 +80,79 @@ class OnlineGame : public gcom::Game
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+        // Files are read and decoded on worker threads, this thread only uploads
+        text_ = std::make_unique<gcom::TextRender>();
+        levels_.resize(4);
+        const u32 level_height{ screen_info_.height / 2 };
+        gcom::AssetLoader loader{};
+
         // Load shaders
-        gcom::ResourceManager::load_shader(
+        loader.add_shader(
             "res/shaders/sprite.vert", "res/shaders/sprite.frag", "", "sprite");
-        gcom::ResourceManager::load_shader("res/shaders/particle.vert",
-                                         "res/shaders/particle.frag",
-                                         "",
-                                         "particle");
-        gcom::ResourceManager::load_shader("res/shaders/postprocessing.vert",
-                                         "res/shaders/postprocessing.frag",
-                                         "",
-                                         "postprocessing");
-
-        // configure shaders
-        glm::mat4 projection{ glm::ortho(0.0f,
-                                         static_cast<float>(screen_info_.width),
-                                         static_cast<float>(screen_info_.height),
-                                         0.0f,
-                                         -1.0f,
-                                         1.0f) };
-
-        gcom::ResourceManager::get_shader("sprite").use().set_integer("image", 0);
-        gcom::ResourceManager::get_shader("sprite").set_matrix4("projection",
-                                                              projection);
-
-        gcom::ResourceManager::get_shader("particle").use().set_integer("sprite", 0);
-        gcom::ResourceManager::get_shader("particle")
-            .set_matrix4("projection", projection);
+        loader.add_shader("res/shaders/sprite_batch.vert",
+                          "res/shaders/sprite_batch.frag",
+                          "",
+                          "sprite_batch");
+        loader.add_shader("res/shaders/particle.vert",
+                          "res/shaders/particle.frag",
+                          "",
+                          "particle");
+        loader.add_shader("res/shaders/postprocessing.vert",
+                          "res/shaders/postprocessing.frag",
+                          "",
+                          "postprocessing");
 
         // Load textures
-        gcom::ResourceManager::load_texture("res/textures/ball.png", true, "ball");
-        gcom::ResourceManager::load_texture(
-            "res/textures/background.jpg", false, "background");
-        gcom::ResourceManager::load_texture("res/textures/block.png", false, "block");
-        gcom::ResourceManager::load_texture(
+        loader.add_texture("res/textures/ball.png", true, "ball");
+        loader.add_texture("res/textures/background.jpg", false, "background");
+        loader.add_texture("res/textures/block.png", false, "block");
+        loader.add_texture(
             "res/textures/indestructible_block.png", false, "indestructible_block");
-        gcom::ResourceManager::load_texture("res/textures/paddle.png", true, "paddle");
+        loader.add_texture("res/textures/paddle.png", true, "paddle");
 
-        gcom::ResourceManager::load_texture(
-            "res/textures/particle.png", true, "particle");
+        loader.add_texture("res/textures/particle.png", true, "particle");
 
-        gcom::ResourceManager::load_texture(
-            "res/textures/powerup_speed.png", true, "powerup_speed");
-        gcom::ResourceManager::load_texture(
+        loader.add_texture("res/textures/powerup_speed.png", true, "powerup_speed");
+        loader.add_texture(
             "res/textures/powerup_sticky.png", true, "powerup_sticky");
-        gcom::ResourceManager::load_texture(
+        loader.add_texture(
             "res/textures/powerup_increase.png", true, "powerup_increase");
-        gcom::ResourceManager::load_texture(
+        loader.add_texture(
             "res/textures/powerup_confuse.png", true, "powerup_confuse");
-        gcom::ResourceManager::load_texture(
-            "res/textures/powerup_chaos.png", true, "powerup_chaos");
-        gcom::ResourceManager::load_texture(
+        loader.add_texture("res/textures/powerup_chaos.png", true, "powerup_chaos");
+        loader.add_texture(
             "res/textures/powerup_passthrough.png", true, "powerup_passthrough");
 
+        loader.add_font("res/fonts/OCRAEXT.TTF", font_size_, *text_);
+
+        // Load levels
+        loader.add_level(
+            "res/levels/one.lvl", screen_info_.width, level_height, levels_[0]);
+        loader.add_level(
+            "res/levels/two.lvl", screen_info_.width, level_height, levels_[1]);
+        loader.add_level(
+            "res/levels/three.lvl", screen_info_.width, level_height, levels_[2]);
+        loader.add_level(
+            "res/levels/four.lvl", screen_info_.width, level_height, levels_[3]);
+
+        if (!load_assets(loader))
+        {
+            return false;
+        }
+
+        // configure shaders
+        init_view_uniforms();
+        gcom::ResourceManager::get_shader("sprite").use().set_integer("image", 0);
+        gcom::ResourceManager::get_shader("sprite_batch")
+            .use()
+            .set_integer("image", 0);
+        gcom::ResourceManager::get_shader("particle").use().set_integer("sprite", 0);
+
         // Set render-specific controls
         sprite_renderer_ = std::make_unique<gcom::SpriteRenderer>(
             gcom::ResourceManager::get_shader("sprite"));
+        sprite_batch_ = std::make_unique<gcom::SpriteBatch>(
+            gcom::ResourceManager::get_shader("sprite_batch"));
         particles_ = std::make_unique<gcom::ParticleGenerator>(
             gcom::ResourceManager::get_shader("particle"),
             gcom::ResourceManager::get_texture("particle"),
@@ -130,23 +162,6 @@ class OnlineGame : public gcom::Game
             screen_info_.width,
             screen_info_.height);
 
-        // Load levels
-        gcom::GameLevel one;
-        one.load("res/levels/one.lvl", screen_info_.width, screen_info_.height / 2);
-        gcom::GameLevel two;
-        two.load("res/levels/two.lvl", screen_info_.width, screen_info_.height / 2);
-        gcom::GameLevel three;
-        three.load(
-            "res/levels/three.lvl", screen_info_.width, screen_info_.height / 2);
-        gcom::GameLevel four;
-        four.load(
-            "res/levels/four.lvl", screen_info_.width, screen_info_.height / 2);
-
-        levels_.push_back(one);
-        levels_.push_back(two);
-        levels_.push_back(three);
-        levels_.push_back(four);
-
         // configure game objects
         // Player 1
         glm::vec2 player_pos{ glm::vec2{ screen_info_.width / 2.0f -
@@ -181,10 +196,6 @@ class OnlineGame : public gcom::Game
             initial_ball_velocity_,
             gcom::ResourceManager::get_texture("ball"));
 
-        text_ = std::make_unique<gcom::TextRender>(screen_info_.width,
-                                                 screen_info_.height);
-        text_->load("res/fonts/OCRAEXT.TTF", font_size_);
-
         // Main Menu theme
         result_ = ma_engine_init(nullptr, &engine_);
         if (result_ != MA_SUCCESS)
@@ -192,6 +203,7 @@ class OnlineGame : public gcom::Game
             std::cerr << "Failed to initialize audio\n";
             return false;
         }
+        register_packed_audio();
 
         stop_and_play_new_sound("res/audio/music/main-menu.wav");
 
@@ -232,8 +244,14 @@ class OnlineGame : public gcom::Game
             // ------
             glClearColor(0.5f, 0.7f, 1.0f, 1.0f); // Soft light blue
             glClear(GL_COLOR_BUFFER_BIT);
+            sprite_batch_->begin_frame();
+            gcom::gl_counters.reset();
             render();
+            last_frame_gl_counters_ = gcom::gl_counters;
 
+            // Everything up to here ran on the CPU this frame, the swap waits for
+            // the GPU
+            frame_cpu_ms_ = (glfwGetTime() - current_frame) * 1000.0;
             glfwSwapBuffers(window_);
         }
 
@@ -261,12 +279,12 @@ class OnlineGame : public gcom::Game
             ImGui::NewFrame();
 
             sprite_renderer_->draw_sprite(
-                gcom::ResourceManager::get_texture("background"),
+                gcom::ResourceManager::get_texture(background_texture_),
                 glm::vec2(0.0f, 0.0f),
                 glm::vec2(screen_info_.width, screen_info_.height),
                 0.0f);
 
-            ImVec2 next_window_size{ 225.0f, 200.0f };
+            ImVec2 next_window_size{ 225.0f, 290.0f };
             ImGui::SetNextWindowSize(next_window_size);
             ImGui::SetNextWindowPos(
                 ImVec2{ static_cast<float>(screen_info_.width / 2 -
@@ -294,6 +312,12 @@ class OnlineGame : public gcom::Game
             ImGui::Text("Enter server port:");
             ImGui::InputInt("##ServerPortInput", &port_, 0, 0);
 
+            ImGui::Text("Interpolation delay (ms):");
+            ImGui::InputInt(
+                "##InterpolationDelayInput", &interpolation_delay_ms_, 0, 0);
+            interpolation_delay_ms_ = std::clamp(interpolation_delay_ms_, 0, 1000);
+            ImGui::Checkbox("Extrapolate late snapshots", &extrapolate_);
+
             ImGui::SetCursorPosX(next_window_size.x / 2 - 29.0f);
             if (ImGui::Button("Connect"))
             {
@@ -351,14 +375,17 @@ class OnlineGame : public gcom::Game
 
         if (state_ == gcom::GameState::WAITING_TO_CONNECT)
         {
-            sprite_renderer_->draw_sprite(
-                gcom::ResourceManager::get_texture("background"),
+            sprite_batch_->add(
+                gcom::ResourceManager::get_texture(background_texture_),
                 glm::vec2(0.0f, 0.0f),
                 glm::vec2(screen_info_.width, screen_info_.height),
-                0.0f);
-            levels_[current_level_].draw(*sprite_renderer_);
+                0.0f,
+                glm::vec3{ 1.0f },
+                LAYER_BACKGROUND);
+            levels_[current_level_].draw(*sprite_batch_, LAYER_WORLD);
+            sprite_batch_->flush();
 
-            text_->render_text(
+            text_->draw_run(
                 "WAITING TO CONNECT...", 100.0f, screen_info_.height / 2, 2.0f);
             return;
         }
@@ -370,21 +397,23 @@ class OnlineGame : public gcom::Game
         {
             effects_->begin_render();
             // Draw background
-            sprite_renderer_->draw_sprite(
-                gcom::ResourceManager::get_texture("background"),
+            sprite_batch_->add(
+                gcom::ResourceManager::get_texture(background_texture_),
                 glm::vec2(0.0f, 0.0f),
                 glm::vec2(screen_info_.width, screen_info_.height),
-                0.0f);
+                0.0f,
+                glm::vec3{ 1.0f },
+                LAYER_BACKGROUND);
 
             // Draw level
-            levels_[current_level_].draw(*sprite_renderer_);
+            levels_[current_level_].draw(*sprite_batch_, LAYER_WORLD);
 
             // Draw World Objs
             for (auto& pair : map_players_)
             {
                 if (pair.second)
                 {
-                    pair.second->draw(*sprite_renderer_);
+                    pair.second->draw(*sprite_batch_, LAYER_WORLD);
                 }
             }
             // local_player_->draw(*sprite_renderer_);
@@ -403,30 +432,47 @@ class OnlineGame : public gcom::Game
             // particles_->draw();
             if (draw_ball_)
             {
-                ball_->draw(*sprite_renderer_);
+                ball_->draw(*sprite_batch_, LAYER_BALL);
             }
+            sprite_batch_->flush();
 
             effects_->end_render();
             effects_->render(glfwGetTime());
 
             // Show lives
-            std::stringstream ss{};
             for (const auto& player_desc : map_players_)
             {
-                ss << player_desc.second->get_desc().lives;
+                const std::string_view lives{ lives_text(
+                    player_desc.second->get_desc().lives) };
                 if (player_desc.second->player_number_ == PlayerNumber::One)
                 {
-                    text_->render_text("Lives " + ss.str(),
-                                       5.0f,
-                                       screen_info_.height - font_size_,
-                                       1.0f);
+                    text_->draw_run(
+                        lives, 5.0f, screen_info_.height - font_size_, 1.0f);
                 }
                 if (player_desc.second->player_number_ == PlayerNumber::Two)
                 {
-                    text_->render_text("Lives " + ss.str(), 5.0f, 5.0f, 1.0f);
+                    text_->draw_run(lives, 5.0f, 5.0f, 1.0f);
                 }
+            }
+
+            if (show_render_stats_)
+            {
+                std::stringstream ss{};
+                const gcom::SpriteBatch::Stats& stats{ sprite_batch_->stats() };
+                ss << std::fixed << std::setprecision(2) << "cpu " << frame_cpu_ms_
+                   << " ms  batch " << stats.cpu_ms << " ms  " << stats.sprites
+                   << " sprites  " << stats.draw_calls << " draws";
+                text_->add_text(ss.str(), 5.0f, 5.0f + font_size_, 0.5f);
                 ss.str("");
-                ss.clear();
+
+                // the frame before, this one is still being drawn
+                const gcom::GLCounters& gl{ last_frame_gl_counters_ };
+                ss << "gl: " << gl.draw_calls << " draws  " << gl.uniform_uploads
+                   << " uniforms  " << gl.uniform_skips << " skipped  "
+                   << gl.location_lookups << " lookups";
+                text_->add_text(ss.str(), 5.0f, 5.0f + font_size_ * 1.5f, 0.5f);
+                // changes every frame, so it isn't cached. One draw, under the menus
+                text_->flush();
             }
 
             ImGui_ImplOpenGL3_NewFrame();
@@ -466,6 +512,8 @@ class OnlineGame : public gcom::Game
                         &engine_, "res/audio/sound/change-selection.wav", nullptr);
 
                     client_.disconnect();
+                    udp_.close();
+                    snapshot_buffer_.clear();
                     map_players_.clear();
                     draw_ball_                  = false;
                     show_game_active_menu_popup = false;
@@ -485,7 +533,7 @@ class OnlineGame : public gcom::Game
 
         if (state_ == gcom::GameState::GAME_READY)
         {
-            text_->render_text(
+            text_->draw_run(
                 "Press ENTER to get ready", 250.0f, screen_info_.height / 2, 1.0f);
             // text_->render_text("Press W or S to select level",
             //                    245.0f,
@@ -495,13 +543,13 @@ class OnlineGame : public gcom::Game
 
         if (state_ == gcom::GameState::WAITING_FOR_OTHER_PLAYER)
         {
-            text_->render_text(
+            text_->draw_run(
                 "Waiting for other player", 250.0f, screen_info_.height / 2, 1.0f);
         }
 
         if (state_ == gcom::GameState::GAME_ENDS)
         {
-            std::string endgame_msg{};
+            std::string_view endgame_msg{};
             glm::vec3 color{};
             if (won_)
             {
@@ -514,18 +562,24 @@ class OnlineGame : public gcom::Game
                 color       = { 1.0f, 0.0f, 0.0f };
             }
 
-            text_->render_text(
+            text_->draw_run(
                 endgame_msg, 320.0, screen_info_.height / 2 - 20.0, 1.0, color);
-            text_->render_text("Press ENTER to return to main menu",
-                               130.0,
-                               screen_info_.height / 2,
-                               1.0,
-                               glm::vec3(1.0, 1.0, 1.0));
+            text_->draw_run("Press ENTER to return to main menu",
+                            130.0,
+                            screen_info_.height / 2,
+                            1.0,
+                            glm::vec3(1.0, 1.0, 1.0));
         }
     }
 
     void process_input(float dt)
     {
+        if (keys_[GLFW_KEY_F3] && !keys_processed_[GLFW_KEY_F3])
+        {
+            show_render_stats_           = !show_render_stats_;
+            keys_processed_[GLFW_KEY_F3] = true;
+        }
+
         // Control of Player object
         if (state_ == gcom::GameState::GAME_READY)
         {
@@ -585,6 +639,8 @@ class OnlineGame : public gcom::Game
                 client_.send(msg_disconnect);
 
                 client_.disconnect();
+                udp_.close();
+                snapshot_buffer_.clear();
                 map_players_.clear();
                 draw_ball_ = false;
 
@@ -595,30 +651,19 @@ class OnlineGame : public gcom::Game
         if (state_ == gcom::GameState::GAME_ACTIVE &&
             map_players_.contains(local_player_id_))
         {
-            float velocity{ player_velocity_ * dt };
-            // move player1_'s paddle
+            // move our paddle now and tell the server how we moved it
+            i8 direction{ 0 };
             if (keys_[GLFW_KEY_A])
             {
-                if (map_players_[local_player_id_]->pos_.x >= 0.0f)
-                {
-                    map_players_[local_player_id_]->pos_.x -= velocity;
-                    // if (ball_->stuck_)
-                    // {
-                    //     ball_->pos_.x -= velocity;
-                    // }
-                }
+                --direction;
             }
             if (keys_[GLFW_KEY_D])
             {
-                if (map_players_[local_player_id_]->pos_.x <=
-                    screen_info_.width - map_players_[local_player_id_]->size_.x)
-                {
-                    map_players_[local_player_id_]->pos_.x += velocity;
-                    // if (ball_->stuck_)
-                    // {
-                    //     ball_->pos_.x += velocity;
-                    // }
-                }
+                ++direction;
+            }
+            if (direction != 0)
+            {
+                predict_input(direction, dt);
             }
             if (keys_[GLFW_KEY_SPACE] &&
                 map_players_[local_player_id_]->player_number_ == PlayerNumber::One)
@@ -638,8 +683,11 @@ class OnlineGame : public gcom::Game
 
     void do_collisions() override
     {
-        for (gcom::GameObject& box : levels_[current_level_].bricks)
+        gcom::GameLevel& level{ levels_[current_level_] };
+        const auto [near_min, near_max]{ collision_bounds(*ball_) };
+        for (const u32 brick : level.bricks_near(near_min, near_max))
         {
+            gcom::GameObject& box{ level.bricks[brick] };
             if (!box.destroyed_)
             {
                 gcom::Collision collision{ check_collision(*ball_, box) };
@@ -758,173 +806,45 @@ class OnlineGame : public gcom::Game
         // Check for incoming network messages
         if (client_.is_connected())
         {
+            udp_.update();
+
+            // Handling state updates must not touch the heap, everything they
+            // write to is already allocated
+            const u64 allocations_before{ alloc_counter::count() };
+            size_t message_count{ 0 };
             while (!client_.incoming().empty())
             {
                 auto msg{ client_.incoming().pop_front().msg };
+                on_message(msg);
+                ++message_count;
+            }
+            while (!udp_.incoming().empty())
+            {
+                auto msg{ udp_.incoming().pop_front() };
+                on_message(msg);
+                ++message_count;
+            }
+            interpolate_remote_state();
 
-                switch (msg.header.id)
-                {
-                case GameMsgTypes::ClientAccepted:
-                {
-                    std::cout << "Server accepted client\n";
-                    map_players_.clear();
-
-                    net::Message<GameMsgTypes> sending_msg{};
-                    sending_msg.header.id = GameMsgTypes::ClientRegisterWithServer;
-
-                    // local_player_ = std::make_shared<gcom::Player>(
-                    //     3,
-                    //     glm::vec2{ 100.0f, 100.0f },
-                    //     player_size_,
-                    //     gcom::ResourceManager::get_texture("paddle"));
-                    // sending_msg << local_player_->get_desc();
-
-                    PlayerDesc local_player_desc{ .pos{ 100.0f, 100.0f },
-                                                  .screen_info{ 800, 600 } };
-                    sending_msg << local_player_desc;
-                    client_.send(sending_msg);
-
-                    break;
-                }
-                case GameMsgTypes::ClientAssignId:
-                {
-                    // Server is assigning us our Id
-                    msg >> local_player_id_;
-                    std::cout << "Assigned client Id = " << local_player_id_ << "\n";
-                    break;
-                }
-                case GameMsgTypes::ServerIsFull:
-                {
-                    client_.disconnect();
-                    map_players_.clear();
-                    draw_ball_              = false;
-                    show_server_full_popup_ = true;
-                    state_                  = gcom::GameState::GAME_MAIN_MENU;
-
-                    stop_and_play_new_sound("res/audio/music/main-menu.wav");
-
-                    break;
-                }
-                case GameMsgTypes::GameAddPlayer:
-                {
-                    PlayerDesc player_desc{};
-                    msg >> player_desc;
-                    if (!map_players_.contains(player_desc.unique_id))
-                    {
-                        auto player{
-                            std::make_shared<gcom::Player>(
-                                3,
-                                glm::vec2{ 0.0f, 0.0f },
-                                player_size_,
-                                gcom::ResourceManager::get_texture("paddle"),
-                                screen_info_),
-                        };
-                        player->set_props(player_desc);
-                        map_players_.insert_or_assign(player->unique_id_, player);
-                    }
-
-                    if (player_desc.unique_id == local_player_id_)
-                    {
-                        // Now we exist in game world
-                        state_ = gcom::GameState::GAME_READY;
-                    }
-                    break;
-                }
-                case GameMsgTypes::GameRemovePlayer:
-                {
-                    u32 removal_id{ 0 };
-                    msg >> removal_id;
-                    map_players_.erase(removal_id);
-                    break;
-                }
-                case GameMsgTypes::GameActive:
-                {
-                    state_ = gcom::GameState::GAME_ACTIVE;
-                    stop_and_play_new_sound("res/audio/music/playing.wav");
-
-                    draw_ball_ = true;
-                    break;
-                }
-                case GameMsgTypes::GameUpdatePlayer:
-                {
-                    PlayerDesc player_desc{};
-                    msg >> player_desc;
-
-                    auto player{ std::make_shared<gcom::Player>(
-                        3,
-                        glm::vec2{ 0.0f, 0.0f },
-                        player_size_,
-                        gcom::ResourceManager::get_texture("paddle"),
-                        screen_info_) };
-                    player->set_props(player_desc);
-
-                    map_players_.insert_or_assign(player->unique_id_, player);
-                    break;
-                }
-                case GameMsgTypes::GameReduceLives:
-                {
-                    PlayerDesc player_desc{};
-                    msg >> player_desc;
-                    auto it = map_players_.find(player_desc.unique_id);
-                    if (it != map_players_.end())
-                    {
-                        it->second->lives_ = player_desc.lives;
-                        if (local_player_id_ == player_desc.unique_id)
-                        {
-                            shake_time_      = 0.05f;
-                            effects_->shake_ = true;
-                            ma_engine_play_sound(
-                                &engine_, "res/audio/sound/solid.wav", nullptr);
-                        }
-                    }
-
-                    break;
-                }
-                case GameMsgTypes::GameUpdateBall:
-                {
-                    BallDesc ball_desc{};
-                    msg >> ball_desc;
-                    ball_->set_props(ball_desc);
-
-                    break;
-                }
-                case GameMsgTypes::GamePlayPadSound:
-                {
-                    ma_engine_play_sound(
-                        &engine_, "res/audio/sound/bleep.wav", nullptr);
-                    break;
-                }
-                case GameMsgTypes::GameEnds:
-                {
-                    // This hacky check prevents the client from rendering the game
-                    // over screen when reconnecting to a game that hasn't been reset
-                    // on the server.
-                    if (client_.is_connected())
-                    {
-                        PlayerNumber winner{};
-                        msg >> winner;
-                        if (map_players_.contains(local_player_id_) &&
-                            winner == map_players_[local_player_id_]->player_number_)
-                        {
-                            won_ = true;
-                        }
-                        state_ = gcom::GameState::GAME_ENDS;
-
-                        if (won_)
-                        {
-                            stop_and_play_new_sound("res/audio/music/victory.wav");
-                        }
-                        else
-                        {
-                            stop_and_play_new_sound("res/audio/music/defeat.wav");
-                        }
-                    }
-                    break;
-                }
-                }
+            if (state_ == gcom::GameState::GAME_ACTIVE)
+            {
+                handled_messages_ += message_count;
+                message_allocations_ += alloc_counter::count() - allocations_before;
             }
         }
 
+#ifdef PONGNET_COUNT_ALLOCATIONS
+        allocation_report_time_ += dt;
+        if (allocation_report_time_ >= ALLOCATION_REPORT_INTERVAL)
+        {
+            std::cout << message_allocations_ << " heap allocations while handling "
+                      << handled_messages_ << " messages\n";
+            handled_messages_       = 0;
+            message_allocations_    = 0;
+            allocation_report_time_ = 0.0f;
+        }
+#endif
+
         // update objects locally
         // if (ball_)
         // {
@@ -965,18 +885,325 @@ class OnlineGame : public gcom::Game
         //     winner_          = gcom::Winner::Player1;
         // }
 
-        // Send our player desc
-        if (map_players_.contains(local_player_id_))
+        // Send the inputs the server hasn't acked yet, whenever there is a new one.
+        // A datagram can get lost, so unacked inputs are also repeated now and then.
+        // After a long loss only the newest ones fit, the server skips the older
+        // ones and reconciliation corrects the paddle for them.
+        input_resend_time_ += dt;
+        if (!pending_inputs_.empty() &&
+            (new_input_ || input_resend_time_ >= INPUT_RESEND_INTERVAL))
         {
+            const size_t count{ std::min(pending_inputs_.size(),
+                                         MAX_INPUTS_PER_SEND) };
+            input_commands_.assign(pending_inputs_.end() - count,
+                                   pending_inputs_.end());
+
+            input_bytes_.clear();
+            gcom::encode_inputs(input_commands_, input_bytes_);
+
             net::Message<GameMsgTypes> msg{};
-            msg.header.id = GameMsgTypes::GameUpdatePlayer;
-            msg << map_players_[local_player_id_]->get_desc();
-            client_.send(msg);
+            msg.header.id = GameMsgTypes::GamePlayerInput;
+            write_bytes(msg, input_bytes_);
+            send_state(msg);
+
+            new_input_         = false;
+            input_resend_time_ = 0.0f;
+        }
+
+        if (snapshot_to_ack_)
+        {
+            net::Message<GameMsgTypes> msg_ack{};
+            msg_ack.header.id = GameMsgTypes::GameSnapshotAck;
+            msg_ack << *snapshot_to_ack_;
+            send_state(msg_ack);
+            snapshot_to_ack_.reset();
         }
 
         return true;
     }
 
+    // Latest-state-wins messages go over UDP once the server answered our hello
+    void send_state(const net::Message<GameMsgTypes>& msg)
+    {
+        if (udp_.is_confirmed())
+        {
+            udp_.send(msg);
+        }
+        else
+        {
+            client_.send(msg);
+        }
+    }
+
+    // Messages from both the TCP connection and the UDP channel end up here
+    void on_message(net::Message<GameMsgTypes>& msg)
+    {
+        switch (msg.header.id)
+        {
+        case GameMsgTypes::ClientAccepted:
+        {
+            std::cout << "Server accepted client\n";
+            map_players_.clear();
+            received_snapshots_.clear();
+            snapshot_buffer_.clear();
+            snapshot_to_ack_.reset();
+            pending_inputs_.clear();
+            next_input_sequence_ = 1;
+
+            net::Message<GameMsgTypes> sending_msg{};
+            sending_msg.header.id = GameMsgTypes::ClientRegisterWithServer;
+
+            // local_player_ = std::make_shared<gcom::Player>(
+            //     3,
+            //     glm::vec2{ 100.0f, 100.0f },
+            //     player_size_,
+            //     gcom::ResourceManager::get_texture("paddle"));
+            // sending_msg << local_player_->get_desc();
+
+            PlayerDesc local_player_desc{ .pos{ 100.0f, 100.0f },
+                                          .screen_info{ 800, 600 } };
+            sending_msg << local_player_desc;
+            client_.send(sending_msg);
+
+            break;
+        }
+        case GameMsgTypes::ClientAssignId:
+        {
+            // Server is assigning us our Id
+            msg >> local_player_id_;
+            std::cout << "Assigned client Id = " << local_player_id_ << "\n";
+            break;
+        }
+        case GameMsgTypes::ClientUdpToken:
+        {
+            // Open the UDP side, high-frequency state moves to it once the server
+            // answers our hello
+            u16 udp_port{ 0 };
+            u32 token{ 0 };
+            msg >> udp_port >> token;
+            udp_.open(client_.ip_to_connect().data(), udp_port, token);
+            break;
+        }
+        case GameMsgTypes::ServerIsFull:
+        {
+            client_.disconnect();
+            udp_.close();
+            snapshot_buffer_.clear();
+            map_players_.clear();
+            draw_ball_              = false;
+            show_server_full_popup_ = true;
+            state_                  = gcom::GameState::GAME_MAIN_MENU;
+
+            stop_and_play_new_sound("res/audio/music/main-menu.wav");
+
+            break;
+        }
+        case GameMsgTypes::GameAddPlayer:
+        {
+            PlayerDesc player_desc{};
+            msg >> player_desc;
+            if (!map_players_.contains(player_desc.unique_id))
+            {
+                auto player{
+                    std::make_shared<gcom::Player>(
+                        3,
+                        glm::vec2{ 0.0f, 0.0f },
+                        player_size_,
+                        gcom::ResourceManager::get_texture(paddle_texture_),
+                        screen_info_),
+                };
+                player->set_props(player_desc);
+                map_players_.insert_or_assign(player->unique_id_, player);
+            }
+
+            if (player_desc.unique_id == local_player_id_)
+            {
+                // Now we exist in game world
+                state_ = gcom::GameState::GAME_READY;
+            }
+            break;
+        }
+        case GameMsgTypes::GameRemovePlayer:
+        {
+            u32 removal_id{ 0 };
+            msg >> removal_id;
+            map_players_.erase(removal_id);
+            break;
+        }
+        case GameMsgTypes::GameActive:
+        {
+            state_ = gcom::GameState::GAME_ACTIVE;
+            stop_and_play_new_sound("res/audio/music/playing.wav");
+
+            draw_ball_ = true;
+            break;
+        }
+        case GameMsgTypes::GameSnapshot:
+        {
+            read_bytes(msg, snapshot_bytes_);
+            std::optional<gcom::Snapshot> snapshot{ gcom::decode_snapshot(
+                snapshot_bytes_, received_snapshots_) };
+            if (!snapshot)
+            {
+                // Its baseline is gone, the server falls back to a full
+                // snapshot once our last ack ages out of its history
+                break;
+            }
+
+            received_snapshots_.store(*snapshot);
+            apply_snapshot(*snapshot);
+
+            if (snapshot->sequence % SNAPSHOT_ACK_INTERVAL == 0)
+            {
+                snapshot_to_ack_ = snapshot->sequence; // sent in update()
+            }
+            break;
+        }
+        case GameMsgTypes::GameEnds:
+        {
+            // This hacky check prevents the client from rendering the game
+            // over screen when reconnecting to a game that hasn't been reset
+            // on the server.
+            if (client_.is_connected())
+            {
+                PlayerNumber winner{};
+                msg >> winner;
+                if (map_players_.contains(local_player_id_) &&
+                    winner == map_players_[local_player_id_]->player_number_)
+                {
+                    won_ = true;
+                }
+                state_ = gcom::GameState::GAME_ENDS;
+
+                if (won_)
+                {
+                    stop_and_play_new_sound("res/audio/music/victory.wav");
+                }
+                else
+                {
+                    stop_and_play_new_sound("res/audio/music/defeat.wav");
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    // Client-side prediction: the command moves our paddle right away with the same
+    // rules the server uses, and is kept until the server acks it
+    void predict_input(i8 direction, float dt)
+    {
+        // Commands are whole milliseconds, the rest carries over to the next frame
+        // so nothing is lost at high frame rates
+        input_time_carry_ += dt * 1000.0f;
+        const float duration_ms{ std::min(std::floor(input_time_carry_),
+                                          static_cast<float>(
+                                              gcom::MAX_INPUT_DURATION_MS)) };
+        input_time_carry_ = std::min(input_time_carry_ - duration_ms, 1.0f);
+        if (duration_ms <= 0.0f)
+        {
+            return;
+        }
+
+        const gcom::InputCommand command{ next_input_sequence_++,
+                                          latest_snapshot_sequence_,
+                                          direction,
+                                          static_cast<u8>(duration_ms) };
+        move_local_paddle(command);
+        pending_inputs_.push_back(command);
+        new_input_ = true;
+    }
+
+    void move_local_paddle(const gcom::InputCommand& command)
+    {
+        auto& player{ map_players_[local_player_id_] };
+        player->pos_.x = gcom::apply_input(player->pos_.x,
+                                           command.direction,
+                                           command.duration_ms / 1000.0f,
+                                           screen_info_.width - player->size_.x);
+    }
+
+    // Reconciliation: take the server's position for our paddle and replay the
+    // inputs it hasn't processed yet on top of it
+    void reconcile(const gcom::Snapshot& snapshot, u32 paddle)
+    {
+        while (!pending_inputs_.empty() &&
+               pending_inputs_.front().sequence <= snapshot.input_ack)
+        {
+            pending_inputs_.pop_front();
+        }
+
+        map_players_[local_player_id_]->pos_ = snapshot.paddle_pos(paddle);
+        for (const auto& command : pending_inputs_)
+        {
+            move_local_paddle(command);
+        }
+    }
+
+    // Events, lives and our own paddle are applied as soon as the snapshot arrives.
+    // The ball and the other paddle go through snapshot_buffer_ and are drawn
+    // interpolated, see interpolate_remote_state()
+    void apply_snapshot(const gcom::Snapshot& snapshot)
+    {
+        latest_snapshot_sequence_ = snapshot.sequence;
+        snapshot_buffer_.push(snapshot, glfwGetTime());
+
+        if (snapshot.events & gcom::Snapshot::EVENT_PAD_HIT)
+        {
+            ma_engine_play_sound(&engine_, "res/audio/sound/bleep.wav", nullptr);
+        }
+
+        for (auto& [id, player] : map_players_)
+        {
+            const u32 paddle{ static_cast<u32>(player->player_number_) -
+                              static_cast<u32>(PlayerNumber::One) };
+            if (paddle >= gcom::Snapshot::PADDLE_COUNT)
+            {
+                continue;
+            }
+
+            if (id == local_player_id_)
+            {
+                reconcile(snapshot, paddle);
+            }
+
+            const u32 lives{ snapshot.paddle_lives(paddle) };
+            if (lives < player->lives_ && id == local_player_id_)
+            {
+                shake_time_      = 0.05f;
+                effects_->shake_ = true;
+                ma_engine_play_sound(&engine_, "res/audio/sound/solid.wav", nullptr);
+            }
+            player->lives_ = lives;
+        }
+    }
+
+    void interpolate_remote_state()
+    {
+        const double max_extrapolation{ extrapolate_ ? MAX_EXTRAPOLATION : 0.0 };
+        std::optional<gcom::SnapshotBuffer::Sample> sample{ snapshot_buffer_.sample(
+            glfwGetTime(),
+            interpolation_delay_ms_ / 1000.0,
+            max_extrapolation,
+            ball_->radius_,
+            ball_->size_) };
+        if (!sample)
+        {
+            return;
+        }
+
+        ball_->set_props(sample->ball);
+        for (auto& [id, player] : map_players_)
+        {
+            const u32 paddle{ static_cast<u32>(player->player_number_) -
+                              static_cast<u32>(PlayerNumber::One) };
+            if (id != local_player_id_ && paddle < gcom::Snapshot::PADDLE_COUNT)
+            {
+                player->pos_ = sample->paddles[paddle];
+            }
+        }
+    }
+
     void stop_and_play_new_sound(std::string_view path)
     {
         ma_sound_stop(&sound_);
@@ -1001,4 +1228,48 @@ class OnlineGame : public gcom::Game
     bool won_{ false };
 
     int port_{ 50000 };
+
+    // Sprites are batched per frame, layers keep what is on top of what
+    static constexpr u32 LAYER_BACKGROUND{ 0 };
+    static constexpr u32 LAYER_WORLD{ 1 };
+    static constexpr u32 LAYER_BALL{ 2 };
+    bool show_render_stats_{ false }; // toggled with F3
+    double frame_cpu_ms_{ 0.0 };
+    gcom::GLCounters last_frame_gl_counters_{};
+
+    // Every snapshot is decoded against an older one, so keep the recent ones
+    gcom::SnapshotHistory received_snapshots_{};
+    u16 latest_snapshot_sequence_{ 0 };
+    std::optional<u16> snapshot_to_ack_{};
+    std::vector<u8> snapshot_bytes_{}; // reused decode buffer
+
+    // Remote state is drawn this far in the past, between two received snapshots
+    gcom::SnapshotBuffer snapshot_buffer_{};
+    int interpolation_delay_ms_{ 100 };
+    bool extrapolate_{ true };
+    static constexpr double MAX_EXTRAPOLATION{ 0.1 }; // seconds
+
+    // Inputs applied locally but not acked by the server yet, oldest first
+    std::deque<gcom::InputCommand> pending_inputs_{};
+    u32 next_input_sequence_{ 1 };
+    float input_time_carry_{ 0.0f }; // milliseconds
+    bool new_input_{ false };
+    float input_resend_time_{ 0.0f };
+    std::vector<u8> input_bytes_{}; // reused encode buffer
+    std::vector<gcom::InputCommand> input_commands_{};
+
+    // Heap allocations made while handling received messages in a match, see
+    // AllocationCounter.h
+    size_t handled_messages_{ 0 };
+    u64 message_allocations_{ 0 };
+    float allocation_report_time_{ 0.0f };
+    static constexpr float ALLOCATION_REPORT_INTERVAL{ 5.0f };
+
+    udp::ClientChannel udp_{};
+    static constexpr float INPUT_RESEND_INTERVAL{ 0.1f };
+    static constexpr size_t MAX_INPUTS_PER_SEND{ 32 };
+
+    // Acking every few snapshots is enough, the server only needs some recent
+    // baseline and older baselines just make deltas a little bigger
+    static constexpr u16 SNAPSHOT_ACK_INTERVAL{ 4 };
 };
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <GameCommon/Common.h>
+#include <GameCommon/Types.h>
 
 enum class GameMsgTypes : u32 {
     ServerGetStatus,
@@ -11,18 +11,19 @@ enum class GameMsgTypes : u32 {
     ClientAssignId,
     ClientRegisterWithServer,
     ClientUnregisterWithServer,
+    ClientUdpToken, // TCP, the token the client signs its datagrams with and the
+                    // server's UDP port
+    ClientUdpHello, // UDP, opens the channel and is answered by the server
 
     GameAddPlayer,
     GameRemovePlayer,
-    GameUpdatePlayer,
+    GamePlayerInput,
     GamePlayerLaunchBall,
     GamePlayerReady,
-    GameReduceLives,
     GameActive,
     GameEnds,
 
-    // Audio
-    GamePlayPadSound,
-
-    GameUpdateBall,
+    // Delta-compressed match state, see gcom::Snapshot
+    GameSnapshot,
+    GameSnapshotAck,
 };
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include <GameCommon/Types.h>
+
+#include <asio.hpp>
+#include <random>
+
+// Forwards UDP datagrams between clients and a server on this machine, dropping and
+// delaying some of them on the way. It is enough to see how the UDP channel copes
+// with a lossy network without leaving the machine: start the server with its UDP
+// port set to the target port and the port clients send to set to the proxy's,
+// start the proxy and connect the clients as usual.
+class LossProxy
+{
+  public:
+    LossProxy(u16 listen_port, u16 target_port, float loss, u32 delay_ms,
+              u32 jitter_ms)
+        : listen_{ context_,
+                   asio::ip::udp::endpoint{ asio::ip::udp::v4(), listen_port } },
+          target_{ asio::ip::address_v4::loopback(), target_port },
+          loss_{ loss },
+          delay_ms_{ delay_ms },
+          jitter_ms_{ jitter_ms }
+    {
+    }
+
+    void run()
+    {
+        receive_from_clients();
+        print_stats();
+        context_.run();
+    }
+
+  private:
+    // Every client gets its own upstream socket, so the server sees one endpoint
+    // per client and its answers can be sent back to the right one
+    struct Route
+    {
+        explicit Route(asio::io_context& context) : upstream{ context } {}
+
+        asio::ip::udp::endpoint client{};
+        asio::ip::udp::socket upstream;
+        std::array<u8, 2048> buffer{};
+    };
+
+    void receive_from_clients()
+    {
+        listen_.async_receive_from(
+            asio::buffer(buffer_),
+            sender_,
+            [this](std::error_code ec, size_t length)
+            {
+                if (!ec)
+                {
+                    Route& route{ route_for(sender_) };
+                    forward(route.upstream, target_, buffer_.data(), length);
+                }
+                receive_from_clients();
+            });
+    }
+
+    void receive_from_server(Route& route)
+    {
+        route.upstream.async_receive(
+            asio::buffer(route.buffer),
+            [this, &route](std::error_code ec, size_t length)
+            {
+                if (!ec)
+                {
+                    forward(listen_, route.client, route.buffer.data(), length);
+                }
+                receive_from_server(route);
+            });
+    }
+
+    Route& route_for(const asio::ip::udp::endpoint& client)
+    {
+        auto it{ routes_.find(client) };
+        if (it != routes_.end())
+        {
+            return *it->second;
+        }
+
+        auto route{ std::make_unique<Route>(context_) };
+        route->client = client;
+        route->upstream.open(asio::ip::udp::v4());
+        Route& added{ *route };
+        routes_.emplace(client, std::move(route));
+        std::cout << "[PROXY] New client " << client << "\n";
+
+        receive_from_server(added);
+        return added;
+    }
+
+    void forward(asio::ip::udp::socket& socket, const asio::ip::udp::endpoint& to,
+                 const u8* data, size_t length)
+    {
+        ++forwarded_;
+        if (chance_(rng_) < loss_)
+        {
+            ++dropped_;
+            return;
+        }
+
+        // Each datagram gets its own delay, so jitter also reorders them
+        auto bytes{ std::make_shared<std::vector<u8>>(data, data + length) };
+        auto timer{ std::make_shared<asio::steady_timer>(
+            context_, std::chrono::milliseconds{ delay_ms_ + jitter_(rng_) }) };
+        timer->async_wait(
+            [&socket, to, bytes, timer](std::error_code ec)
+            {
+                if (!ec)
+                {
+                    socket.async_send_to(asio::buffer(*bytes),
+                                         to,
+                                         [bytes](std::error_code, size_t) {});
+                }
+            });
+    }
+
+    void print_stats()
+    {
+        stats_timer_.expires_after(std::chrono::seconds{ 5 });
+        stats_timer_.async_wait(
+            [this](std::error_code ec)
+            {
+                if (ec)
+                {
+                    return;
+                }
+                std::cout << "[PROXY] " << forwarded_ << " datagrams, " << dropped_
+                          << " dropped\n";
+                print_stats();
+            });
+    }
+
+  private:
+    asio::io_context context_{};
+    asio::ip::udp::socket listen_;
+    const asio::ip::udp::endpoint target_;
+    std::array<u8, 2048> buffer_{};
+    asio::ip::udp::endpoint sender_{};
+    std::map<asio::ip::udp::endpoint, std::unique_ptr<Route>> routes_{};
+
+    const float loss_;
+    const u32 delay_ms_;
+    const u32 jitter_ms_;
+    std::mt19937 rng_{ std::random_device{}() };
+    std::uniform_real_distribution<float> chance_{ 0.0f, 1.0f };
+    std::uniform_int_distribution<u32> jitter_{ 0, jitter_ms_ };
+
+    asio::steady_timer stats_timer_{ context_ };
+    u64 forwarded_{ 0 };
+    u64 dropped_{ 0 };
+};
+
+int prompt_int(std::string_view prompt, int min, int max)
+{
+    while (true)
+    {
+        std::cout << prompt;
+        int value{};
+        std::cin >> value;
+
+        if (!std::cin || value < min || value > max)
+        {
+            if (std::cin.eof())
+            {
+                std::exit(0);
+            }
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Invalid value. Please try again\n";
+            continue;
+        }
+
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return value;
+    }
+}
+
+int main()
+{
+    const int listen_port{ prompt_int("Port the clients send to: ", 1, 65535) };
+    const int target_port{ prompt_int("UDP port of the server: ", 1, 65535) };
+    const int loss{ prompt_int("Loss in percent: ", 0, 100) };
+    const int delay{ prompt_int("Delay in ms: ", 0, 10000) };
+    const int jitter{ prompt_int("Jitter in ms: ", 0, 10000) };
+
+    try
+    {
+        LossProxy proxy{ static_cast<u16>(listen_port),
+                         static_cast<u16>(target_port),
+                         static_cast<float>(loss) / 100.0f,
+                         static_cast<u32>(delay),
+                         static_cast<u32>(jitter) };
+        proxy.run();
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "[PROXY] Exception: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
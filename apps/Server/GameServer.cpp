@@ -1,29 +1,84 @@
-#include <GameCommon/Common.h>
+#include <GameCommon/Types.h>
 #include <NetCommon/NetCommon.h>
 #include "../GameMsgTypes.h"
-#include <GameCommon/PlayerDesc.h>
-#include "GameCommon/ResourceManager.h"
-#include "GameCommon/Game.h"
-#include "GameCommon/ScreenInfo.h"
+#include "Shard.h"
+#include "../UdpChannel.h"
 #include "NetCommon/NetConnection.h"
 #include "NetCommon/NetMessage.h"
 #include "NetCommon/NetServer.h"
-#include "glm/detail/qualifier.hpp"
-#include "glm/fwd.hpp"
-#include <GameCommon/BallDesc.h>
 
+#include <random>
+#include <unordered_set>
+
+// The Server is only a router: it pins every connection to one Shard and forwards
+// the connection's messages to that shard's queue. All game state lives in the
+// shards, each ticking its own matches on its own thread. Datagrams from the UDP
+// channel are routed to the same shard as the client's TCP messages.
 class Server : public net::ServerInterface<GameMsgTypes>
 {
   public:
-    Server(u16 port) : net::ServerInterface<GameMsgTypes>{ port }
+    // Clients are told to send their datagrams to advertised_udp_port, which is
+    // udp_port unless something like LossProxy sits in between
+    Server(u16 port, u16 udp_port, u16 advertised_udp_port, u32 tick_rate,
+           u32 snapshot_rate, u32 shard_count, u32 max_matches)
+        : net::ServerInterface<GameMsgTypes>{ port },
+          udp_port_{ udp_port },
+          advertised_udp_port_{ advertised_udp_port },
+          udp_{ [this](ClientConnection client,
+                       u32 shard_index,
+                       net::Message<GameMsgTypes>&& msg)
+                { shards_[shard_index]->post(std::move(client), std::move(msg)); } }
+    {
+        const u32 matches_per_shard{ std::max(1u, max_matches / shard_count) };
+        for (u32 i{ 0 }; i < shard_count; ++i)
+        {
+            shards_.push_back(std::make_unique<Shard>(
+                tick_rate, snapshot_rate, matches_per_shard, udp_));
+        }
+    }
+
+    ~Server()
+    {
+        for (auto& shard : shards_)
+        {
+            shard->stop();
+        }
+        udp_.stop();
+    }
+
+    void start_shards()
     {
-        if (!glfwInit())
+        for (auto& shard : shards_)
         {
-            std::cerr << "Failed to initialize GLFW\n";
+            shard->start();
         }
+        std::cout << "[SERVER] Running " << shards_.size() << " shards\n";
     }
 
-    ~Server() { glfwTerminate(); }
+    bool start_udp() { return udp_.start(udp_port_); }
+
+    // NetCommon only notices a dropped connection when it sends to it, and the
+    // router never does, the shards send on their own. So main() calls this
+    // between updates and it forgets the clients whose connection is gone.
+    void prune_disconnected()
+    {
+        const auto now{ std::chrono::steady_clock::now() };
+        if (now - last_prune_ < PRUNE_INTERVAL)
+        {
+            return;
+        }
+        last_prune_ = now;
+
+        for (auto it{ connections_.begin() }; it != connections_.end();)
+        {
+            const ClientConnection client{ it->second };
+            ++it;
+            if (!client->is_connected())
+            {
+                on_client_disconnect(client);
+            }
+        }
+    }
 
   protected:
     bool
@@ -49,505 +104,160 @@ class Server : public net::ServerInterface<GameMsgTypes>
         std::cout << "A player disconnected\n";
         if (client)
         {
-            if (!map_player_roster_.contains(client->id()))
+            auto it{ client_shards_.find(client->id()) };
+            if (it != client_shards_.end())
             {
+                std::cout << "[Disconnected Unexpectedly]:" +
+                                 std::to_string(client->id()) + "\n";
+
+                // Let the owning shard drop the player from its match
+                net::Message<GameMsgTypes> msg_unregister{};
+                msg_unregister.header.id = GameMsgTypes::ClientUnregisterWithServer;
+                shards_[it->second]->post(client, std::move(msg_unregister));
+
+                client_shards_.erase(it);
             }
-            else
+
+            auto token{ client_tokens_.find(client->id()) };
+            if (token != client_tokens_.end())
             {
-                auto& player_disconnect{ map_player_roster_[client->id()] };
-                std::cout << "[Disconnected Unexpectedly]:" +
-                                 std::to_string(player_disconnect.unique_id) + "\n";
-                map_player_roster_.erase(client->id());
-                garbage_ids_.push_back(client->id());
+                udp_.remove_peer(client->id());
+                tokens_in_use_.erase(token->second);
+                client_tokens_.erase(token);
             }
+
+            if (waiting_client_ && waiting_client_->first == client->id())
+            {
+                waiting_client_.reset();
+            }
+            connections_.erase(client->id());
         }
     }
 
     void on_message(std::shared_ptr<net::Connection<GameMsgTypes>> client,
                     net::Message<GameMsgTypes>& msg) override
     {
-        if (!garbage_ids_.empty())
-        {
-            for (auto player_id : garbage_ids_)
-            {
-                net::Message<GameMsgTypes> m{};
-                m.header.id = GameMsgTypes::GameRemovePlayer;
-                m << player_id;
-                std::cout << "Removing " << player_id << "\n";
-                message_all_clients(m);
-            }
-            garbage_ids_.clear();
-        }
-
         switch (msg.header.id)
         {
         case GameMsgTypes::ClientRegisterWithServer:
         {
-            PlayerDesc player_desc{ 0, 3, { 0.0f, 0.0f } };
-            msg >> player_desc;
-
-            temp_player_id_ = player_desc.unique_id;
-
-            if (map_player_roster_.size() < MAX_PLAYERS && allow_connections_)
+            if (client_shards_.contains(client->id()))
             {
-                player_desc.unique_id = client->id();
-                // map_player_roster_.insert_or_assign(player_desc.unique_id,
-                //                                     player_desc);
-
-                net::Message<GameMsgTypes> msg_send_id{};
-                msg_send_id.header.id = GameMsgTypes::ClientAssignId;
-                msg_send_id << player_desc.unique_id;
-                message_client(client, msg_send_id);
-
-                net::Message<GameMsgTypes> msg_add_player{};
-                msg_add_player.header.id = GameMsgTypes::GameAddPlayer;
-
-                glm::vec2 player_pos{
-                    glm::vec2{ player_desc.screen_info.width / 2.0f -
-                                   player_desc.size.x / 2.0f,
-                               0 },
-                }; // position for player 2
-
-                if (!has_player_one_)
-                {
-                    player_pos = glm::vec2{
-                        player_desc.screen_info.width / 2.0f -
-                            player_desc.size.x / 2.0f,
-                        player_desc.screen_info.height - player_desc.size.y
-                    }; // Set the position for player 1
-
-                    has_player_one_           = true;
-                    player_desc.player_number = PlayerNumber::One;
-                }
-                else
-                {
-                    player_desc.player_number = PlayerNumber::Two;
-                    // Also add the ball now that we have 2 players
-                    const glm::vec2 player_size{ 100.0f, 20.0f };
-                    const float player_velocity{ 500.0f };
-
-                    glm::vec2 player1_pos{ glm::vec2{
-                        player_desc.screen_info.width / 2.0f - player_size.x / 2.0f,
-                        player_desc.screen_info.height - player_size.y } };
-
-                    glm::vec2 ball_pos{
-                        player1_pos + glm::vec2{ player_size.x / 2.0f - ball_radius_,
-                                                 -ball_radius_ * 2.0f }
-                    };
-
-                    ball_ = { ball_radius_,
-                              true,
-                              ball_pos,
-                              initial_ball_velocity_,
-                              glm::vec2{ ball_radius_ * 2.0, ball_radius_ * 2.0 } };
-                              
-                    allow_connections_ = false; // The server now has 2 players,
-                                                // prevent all further connections
-                }
-                player_desc.pos = player_pos;
-
-                msg_add_player << player_desc;
-                message_all_clients(msg_add_player);
-
-                // Also update player's desc on the server
-                map_player_roster_.insert_or_assign(player_desc.unique_id,
-                                                    player_desc);
-
-                for (const auto& player : map_player_roster_)
-                {
-                    net::Message<GameMsgTypes> msg_add_other_players{};
-                    msg_add_other_players.header.id = GameMsgTypes::GameAddPlayer;
-                    msg_add_other_players << player.second;
-                    message_client(client, msg_add_other_players);
-                }
+                break; // Already pinned
             }
-            else
+
+            std::optional<u32> shard_index{ pick_shard(client->id()) };
+            if (!shard_index)
             {
                 net::Message<GameMsgTypes> msg_server_is_full{};
                 msg_server_is_full.header.id = GameMsgTypes::ServerIsFull;
                 message_client(client, msg_server_is_full);
+                break;
             }
 
-            break;
-        }
-        case GameMsgTypes::ClientUnregisterWithServer:
-        {
-            on_client_disconnect(client);
-            break;
-        }
-        case GameMsgTypes::GameUpdatePlayer:
-        {
-            PlayerDesc player_desc{ 0, 3, { 0.0f, 0.0f } };
-            msg >> player_desc;
-            temp_player_id_ = player_desc.unique_id;
-
-            if (ball_.stuck && map_player_roster_.contains(player_desc.unique_id) &&
-                map_player_roster_[player_desc.unique_id].player_number ==
-                    PlayerNumber::One)
-            {
-                glm::vec2 ball_pos{ player_desc.pos +
-                                    glm::vec2{ player_desc.size.x / 2.0f -
-                                                   ball_radius_,
-                                               -ball_radius_ * 2.0f } };
-                ball_.pos = ball_pos;
-            }
-
-            // Bounce update to everyone except incoming client
-            net::Message<GameMsgTypes> msg_bounce{};
-            msg_bounce.header.id = GameMsgTypes::GameUpdatePlayer;
-            msg_bounce << player_desc;
-            message_all_clients(msg_bounce, client);
+            client_shards_.insert_or_assign(client->id(), *shard_index);
+            connections_.insert_or_assign(client->id(), client);
+            shards_[*shard_index]->post(client, std::move(msg));
 
-            // Also update player's desc on the server
-            map_player_roster_.insert_or_assign(player_desc.unique_id, player_desc);
+            // Let the client open its UDP side, its datagrams go to the same shard
+            const u32 token{ new_token() };
+            client_tokens_.insert_or_assign(client->id(), token);
+            udp_.add_peer(client, token, *shard_index);
 
+            net::Message<GameMsgTypes> msg_udp_token{};
+            msg_udp_token.header.id = GameMsgTypes::ClientUdpToken;
+            msg_udp_token << token << advertised_udp_port_;
+            message_client(client, msg_udp_token);
             break;
         }
-        case GameMsgTypes::GamePlayerLaunchBall:
+        case GameMsgTypes::ClientUnregisterWithServer:
         {
-            ball_.stuck = false;
+            on_client_disconnect(client);
             break;
         }
-        case GameMsgTypes::GamePlayerReady:
+        default:
         {
-            // Also update player's is_ready on the server
-            auto it{ map_player_roster_.find(client->id()) };
-            if (it != map_player_roster_.end())
+            auto it{ client_shards_.find(client->id()) };
+            if (it != client_shards_.end())
             {
-                it->second.is_ready = true;
+                shards_[it->second]->post(client, std::move(msg));
             }
-
-            bool player_one_ready{ false };
-            bool player_two_ready{ false };
-            for (const auto& [id, player] : map_player_roster_)
-            {
-                if (player.player_number == PlayerNumber::One && player.is_ready)
-                {
-                    player_one_ready = true;
-                }
-
-                if (player.player_number == PlayerNumber::Two && player.is_ready)
-                {
-                    player_two_ready = true;
-                }
-            }
-
-            if (player_one_ready && player_two_ready)
-            {
-                game_active_ = true;
-                net::Message<GameMsgTypes> msg_game_playing{};
-                msg_game_playing.header.id = GameMsgTypes::GameActive;
-                message_all_clients(msg_game_playing);
-            }
-
             break;
         }
         }
     }
 
-    void do_collisions()
-    {
-        if (map_player_roster_.contains(temp_player_id_))
-        {
-            // check collisions for player 1 pad (unless stuck)
-            gcom::Collision result{ check_collision(
-                ball_, map_player_roster_[temp_player_id_]) };
-            if (map_player_roster_[temp_player_id_].player_number ==
-                PlayerNumber::One)
-            {
-                if (!ball_.stuck && std::get<0>(result))
-                {
-                    // check where it hit the board, and change velocity based on
-                    // where it hit the board
-                    float center_board{ map_player_roster_[temp_player_id_].pos.x +
-                                        map_player_roster_[temp_player_id_].size.x /
-                                            2.0f };
-                    float distance{ ball_.pos.x + ball_.radius - center_board };
-                    float percentage{ distance /
-                                      (map_player_roster_[temp_player_id_].size.x /
-                                       2.0f) };
-
-                    // then move accordingly
-                    float strength{ 2.0f };
-                    glm::vec2 old_velocity{ ball_.velocity };
-                    ball_.velocity.x =
-                        initial_ball_velocity_.x * percentage * strength;
-                    // ball_.velocity.y = -ball_.velocity.y;
-                    ball_.velocity.y =
-                        -1.0f * abs(ball_.velocity.y); // avoid sticky paddle issue
-                    ball_.velocity =
-                        glm::normalize(ball_.velocity) * glm::length(old_velocity);
-
-                    // ball_.stuck = ball_.sticky;
-
-                    // ma_engine_play_sound(&engine_, "res/audio/bleep.wav",
-                    // nullptr);
-                    net::Message<GameMsgTypes> msg_play_pad_sound{};
-                    msg_play_pad_sound.header.id = GameMsgTypes::GamePlayPadSound;
-                    message_all_clients(msg_play_pad_sound);
-                }
-            }
-
-            if (map_player_roster_[temp_player_id_].player_number ==
-                PlayerNumber::Two)
-            {
-                if (!ball_.stuck && std::get<0>(result))
-                {
-                    // check where it hit the board, and change velocity based on
-                    // where it hit the board
-                    float center_board{ map_player_roster_[temp_player_id_].pos.x +
-                                        map_player_roster_[temp_player_id_].size.x /
-                                            2.0f };
-                    float distance{ ball_.pos.x + ball_.radius - center_board };
-                    float percentage{ distance /
-                                      (map_player_roster_[temp_player_id_].size.x /
-                                       2.0f) };
-
-                    // then move accordingly
-                    float strength{ 2.0f };
-                    glm::vec2 old_velocity{ ball_.velocity };
-                    ball_.velocity.x =
-                        initial_ball_velocity_.x * percentage * strength;
-                    // ball_.velocity.y = -ball_.velocity.y;
-                    ball_.velocity.y =
-                        -1.0f * abs(ball_.velocity.y); // avoid sticky paddle issue
-                    ball_.velocity =
-                        glm::normalize(-ball_.velocity) *
-                        glm::length(
-                            old_velocity); // Flip the velocity_ of the player 2
-                                           // pad to shoot the ball downward
-
-                                           // ball_->stuck_ = ball_->sticky_;
-
-                    // ma_engine_play_sound(&engine_, "res/audio/bleep.wav",
-                    // nullptr);
-                    net::Message<GameMsgTypes> msg_play_pad_sound{};
-                    msg_play_pad_sound.header.id = GameMsgTypes::GamePlayPadSound;
-                    message_all_clients(msg_play_pad_sound);
-                }
-            }
-        }
-        // check collisions for player 2 pad
-    }
-
-
-    gcom::Collision check_collision(const BallDesc& one, const PlayerDesc& two)
-    {
-        // get center point circle first
-        glm::vec2 center{ one.pos + one.radius };
-        // calculate AABB info (center, half-extents)
-        glm::vec2 aabb_half_extents{ two.size.x / 2.0f, two.size.y / 2.0f };
-        glm::vec2 aabb_center{ two.pos.x + aabb_half_extents.x,
-                               two.pos.y + aabb_half_extents.y };
-        // get difference vector between both centers
-        glm::vec2 difference{ center - aabb_center };
-        glm::vec2 clamped{ glm::clamp(
-            difference, -aabb_half_extents, aabb_half_extents) };
-        // add clamped value to AABB_center and we get the value of box closest to
-        // circle
-        glm::vec2 closest{ aabb_center + clamped };
-        // retrieve vector between center circle and closest point AABB and check if
-        // length <= radius
-        difference = closest - center;
-        if (glm::length(difference) <= one.radius)
-            return std::make_tuple(true, vector_direction(difference), difference);
-        else
-            return std::make_tuple(false, gcom::Direction::UP, glm::vec2(0.0f, 0.0f));
-    }
-
-    gcom::Direction vector_direction(const glm::vec2& target)
+  private:
+    // Registrations are paired up on the router: the first client of a pair goes to
+    // the least loaded shard and the second one follows it there, so the shard's own
+    // matchmaking seats them in the same match.
+    std::optional<u32> pick_shard(u32 client_id)
     {
-        std::array<glm::vec2, 4> compass{
-            glm::vec2(0.0f, 1.0f),  // up
-            glm::vec2(1.0f, 0.0f),  // right
-            glm::vec2(0.0f, -1.0f), // down
-            glm::vec2(-1.0f, 0.0f)  // left
-        };
-
-        float max{ 0.0f };
-        u32 best_match{ 4294967295 };
-        for (u32 i{ 0 }; i < 4; ++i)
+        // A waiting client that dropped has already left its match, pairing with it
+        // would leave this client alone in a new one
+        if (waiting_client_)
         {
-            float dot_product{ glm::dot(glm::normalize(target), compass[i]) };
-            if (dot_product > max)
+            auto waiting{ connections_.find(waiting_client_->first) };
+            if (waiting != connections_.end() && !waiting->second->is_connected())
             {
-                max        = dot_product;
-                best_match = i;
+                on_client_disconnect(waiting->second);
             }
         }
-        return static_cast<gcom::Direction>(best_match);
-    }
 
-  public:
-    void update(size_t max_messages, bool wait)
-    {
-        if (wait)
-            messages_in_.wait();
-
-        size_t message_count{ 0 };
-        // calculate delta time
-        double current_frame = glfwGetTime();
-        delta_time_          = current_frame - last_frame_;
-        last_frame_          = current_frame;
-        while (message_count < max_messages && !messages_in_.empty())
+        if (waiting_client_)
         {
-
-            // Grab the front message
-            auto msg{ messages_in_.pop_front() };
-
-            // Pass to message handler
-            on_message(msg.remote, msg.msg);
-            tick(delta_time_);
-
-            ++message_count;
+            const u32 shard_index{ waiting_client_->second };
+            waiting_client_.reset();
+            return shard_index;
         }
-    }
 
-  private:
-    void tick(float dt)
-    {
-        if (!game_active_ && !allow_connections_ && map_player_roster_.empty())
-        {
-            reset_game();
-        }
-        if (game_active_)
+        u32 best{ 0 };
+        for (u32 i{ 1 }; i < shards_.size(); ++i)
         {
-            update_ball(dt);
-            do_collisions();
-            broadcast_game_state();
+            if (shards_[i]->match_count() < shards_[best]->match_count())
+            {
+                best = i;
+            }
         }
-    }
 
-    void update_ball(float dt)
-    {
-        // if not stuck to player board
-        if (!ball_.stuck && map_player_roster_.contains(temp_player_id_))
+        if (shards_[best]->is_full())
         {
-            // move the ball
-            ball_.pos += ball_.velocity * dt;
-            // check if outside window bounds; if so, reverse velocity and
-            // restore at correct pos
-            if (ball_.pos.x <= 0.0f)
-            {
-                ball_.velocity.x = -ball_.velocity.x;
-                ball_.pos.x      = 0.0f;
-            }
-            else if (ball_.pos.x + ball_.size.x >=
-                     map_player_roster_[temp_player_id_].screen_info.width)
-            {
-                ball_.velocity.x = -ball_.velocity.x;
-                ball_.pos.x = map_player_roster_[temp_player_id_].screen_info.width -
-                              ball_.size.x;
-            }
-            if (ball_.pos.y <= 0.0f)
-            {
-                ball_.velocity.y = -ball_.velocity.y;
-                ball_.pos.y      = 0.0f;
-            }
-            else if (ball_.pos.y + ball_.size.y >=
-                     map_player_roster_[temp_player_id_].screen_info.height)
-            {
-                ball_.velocity.y = -ball_.velocity.y;
-                ball_.pos.y =
-                    map_player_roster_[temp_player_id_].screen_info.height -
-                    ball_.size.y;
-            }
+            return std::nullopt;
         }
-    }
 
-    void broadcast_game_ends(PlayerNumber winner)
-    {
-        net::Message<GameMsgTypes> msg_game_ends{};
-        msg_game_ends.header.id = GameMsgTypes::GameEnds;
-        winner_                 = winner;
-        msg_game_ends << winner_;
-        message_all_clients(msg_game_ends);
-        game_active_ = false;
+        waiting_client_ = std::make_pair(client_id, best);
+        return best;
     }
 
-    void broadcast_game_state()
+    // Random and unique among connected clients, 0 is never handed out
+    u32 new_token()
     {
-        // reduce player 1 and 2 lives
-        PlayerDesc sending_player_desc{};
-
-        for (auto& player_desc : map_player_roster_)
+        u32 token{ 0 };
+        while (token == 0 || tokens_in_use_.contains(token))
         {
-            if (map_player_roster_.size() <
-                MAX_PLAYERS) // If a player quits the game, the remaining player wins
-            {
-                broadcast_game_ends(player_desc.second.player_number);
-            }
-
-            if (player_desc.second.player_number == PlayerNumber::One &&
-                player_desc.second.lives <= 0)
-            {
-                broadcast_game_ends(PlayerNumber::Two);
-                break;
-            }
-
-            if (player_desc.second.player_number == PlayerNumber::Two &&
-                player_desc.second.lives <= 0)
-            {
-                broadcast_game_ends(PlayerNumber::One);
-                break;
-            }
-
-            if (player_desc.second.player_number == PlayerNumber::One &&
-                ball_.pos.y >= player_desc.second.screen_info.height - ball_.size.y)
-            {
-                --player_desc.second.lives;
-                sending_player_desc = player_desc.second;
-                break;
-            }
-
-            if (player_desc.second.player_number == PlayerNumber::Two &&
-                ball_.pos.y <= 0)
-            {
-                --player_desc.second.lives;
-                sending_player_desc = player_desc.second;
-                break;
-            }
+            token = token_rng_();
         }
-        net::Message<GameMsgTypes> msg_reduce_lives{};
-        msg_reduce_lives.header.id = GameMsgTypes::GameReduceLives;
-        msg_reduce_lives << sending_player_desc;
-        message_all_clients(msg_reduce_lives);
-
-        net::Message<GameMsgTypes> msg_update_ball{};
-        msg_update_ball.header.id = GameMsgTypes::GameUpdateBall;
-        msg_update_ball << ball_;
-        message_all_clients(msg_update_ball);
-    }
-
-    void reset_game()
-    {
-        has_player_one_ = false;
-        temp_player_id_ = 0;
-        winner_         = PlayerNumber::Zero;
-
-        game_active_       = false;
-        allow_connections_ = true;
+        tokens_in_use_.insert(token);
+        return token;
     }
 
   private:
-    std::unordered_map<u32, PlayerDesc> map_player_roster_{};
-    BallDesc ball_;
-    std::vector<u32> garbage_ids_;
-    bool has_player_one_{ false };
-    const glm::vec2 initial_ball_velocity_{ 100.0f, -350.0f };
-    const float ball_radius_{ 12.5f };
-    const float player_velocity_{ 500.0f };
-    u32 temp_player_id_{};
-
-    PlayerNumber winner_{ PlayerNumber::Zero };
-
-    double delta_time_{ 0.0 };
-    double last_frame_{ 0.0 };
-
-    bool game_active_{ false };
-    bool allow_connections_{ true };
-
-    const int MAX_PLAYERS{ 2 };
+    const u16 udp_port_;
+    const u16 advertised_udp_port_;
+    // Declared before the shards, which send through it
+    udp::ServerChannel udp_;
+    std::vector<std::unique_ptr<Shard>> shards_{};
+
+    // Only touched by the router thread
+    std::unordered_map<u32, u32> client_shards_{}; // client id -> shard index
+    std::unordered_map<u32, ClientConnection> connections_{}; // registered clients
+    std::optional<std::pair<u32, u32>> waiting_client_{}; // client id, shard index
+    std::unordered_map<u32, u32> client_tokens_{};       // client id -> UDP token
+    std::unordered_set<u32> tokens_in_use_{};
+    std::mt19937 token_rng_{ std::random_device{}() };
+    std::chrono::steady_clock::time_point last_prune_{};
+
+    static constexpr std::chrono::milliseconds PRUNE_INTERVAL{ 100 };
 };
 
 bool clear_failed_extraction()
@@ -587,13 +297,103 @@ uint16_t prompt_port()
     }
 }
 
+u16 prompt_udp_port(std::string_view prompt, u16 port)
+{
+    while (true)
+    {
+        std::cout << prompt << " (0 to use " << port << "): ";
+        int udp_port{};
+        std::cin >> udp_port;
+
+        if (clear_failed_extraction() || udp_port < 0)
+        {
+            std::cout << "Invalid port. Please try again\n";
+            continue;
+        }
+
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
+                        '\n'); // Remove the bad input
+        return udp_port == 0 ? port : static_cast<u16>(udp_port);
+    }
+}
+
+// Upper bound on concurrent rooms hosted by one process
+constexpr u32 MAX_MATCHES{ 4096 };
+
+// The router polls, so it gets to prune_disconnected() while no TCP messages
+// arrive, which is most of a match now that game state goes over UDP
+constexpr std::chrono::milliseconds ROUTER_IDLE{ 1 };
+
+u32 prompt_tick_rate()
+{
+    while (true)
+    {
+        std::cout << "Enter the simulation tick rate in Hz (e.g. 30, 60, 120): ";
+        int tick_rate{};
+        std::cin >> tick_rate;
+
+        if (clear_failed_extraction() || tick_rate <= 0)
+        {
+            std::cout << "Invalid tick rate. Please try again\n";
+            continue;
+        }
+
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
+                        '\n'); // Remove the bad input
+        return static_cast<u32>(tick_rate);
+    }
+}
+
+u32 prompt_snapshot_rate(u32 tick_rate)
+{
+    while (true)
+    {
+        std::cout << "Enter the snapshot send rate in Hz, at most the tick rate "
+                     "(e.g. 30, 0 for every tick): ";
+        int snapshot_rate{};
+        std::cin >> snapshot_rate;
+
+        if (clear_failed_extraction() || snapshot_rate < 0 ||
+            static_cast<u32>(snapshot_rate) > tick_rate)
+        {
+            std::cout << "Invalid snapshot rate. Please try again\n";
+            continue;
+        }
+
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
+                        '\n'); // Remove the bad input
+        return snapshot_rate == 0 ? tick_rate : static_cast<u32>(snapshot_rate);
+    }
+}
+
 int main()
 {
-    Server server{ prompt_port() };
+    const u16 port{ prompt_port() };
+    const u16 udp_port{ prompt_udp_port("Enter the UDP port for game state", port) };
+    const u16 advertised_udp_port{ prompt_udp_port(
+        "Enter the UDP port clients send to, a LossProxy's port if you use one",
+        udp_port) };
+    const u32 tick_rate{ prompt_tick_rate() };
+    const u32 snapshot_rate{ prompt_snapshot_rate(tick_rate) };
+
+    // One match worker per core
+    const u32 shard_count{ std::max(1u, std::thread::hardware_concurrency()) };
+
+    Server server{ port,          udp_port,    advertised_udp_port, tick_rate,
+                   snapshot_rate, shard_count, MAX_MATCHES };
+    // Clients would be told a port nobody listens on
+    if (!server.start_udp())
+    {
+        std::cerr << "[SERVER] Could not open UDP port " << udp_port << "\n";
+        return 1;
+    }
+    server.start_shards();
     server.start();
     while (true)
     {
-        server.update(65535, true);
+        server.update(65535, false);
+        server.prune_disconnected();
+        std::this_thread::sleep_for(ROUTER_IDLE);
     }
     return 0;
 }
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <GameCommon/Types.h>
+#include <NetCommon/NetCommon.h>
+#include "../GameMsgTypes.h"
+#include <GameCommon/PlayerDesc.h>
+#include "GameCommon/ScreenInfo.h"
+#include "NetCommon/NetConnection.h"
+#include "NetCommon/NetMessage.h"
+#include <GameCommon/BallDesc.h>
+#include <GameCommon/BallBatch.h>
+#include <GameCommon/Snapshot.h>
+#include <GameCommon/InputCommand.h>
+#include "../SnapshotMsg.h"
+#include "../UdpChannel.h"
+
+using ClientConnection = std::shared_ptr<net::Connection<GameMsgTypes>>;
+
+// A single Pong room. A match owns its own roster and state machine and only ever
+// talks to the clients that were matched into it. Its ball lives in the shard's
+// BallBatch: the shard integrates and collides every ball at once, then lets each
+// match react to its own results in step(). Once per tick the match state is sent
+// to each client as a gcom::Snapshot over the UDP channel, delta-encoded against the
+// last snapshot that client acknowledged.
+class Match
+{
+  public:
+    Match(u32 id, gcom::BallBatch& balls, udp::ServerChannel& udp)
+        : id_{ id }, balls_{ balls }, udp_{ udp }
+    {
+    }
+
+    ~Match()
+    {
+        if (ball_slot_)
+        {
+            balls_.remove(*ball_slot_);
+        }
+    }
+
+    Match(const Match&)            = delete;
+    Match& operator=(const Match&) = delete;
+
+    u32 id() const { return id_; }
+
+    // Still waiting for players to join
+    bool is_open() const
+    {
+        return allow_connections_ && map_player_roster_.size() < MAX_PLAYERS;
+    }
+
+    // Every player that joined has left again, the match can be destroyed
+    bool is_finished() const { return has_player_one_ && map_player_roster_.empty(); }
+
+    size_t player_count() const { return map_player_roster_.size(); }
+
+    bool has_player(u32 client_id) const
+    {
+        return map_player_roster_.contains(client_id);
+    }
+
+    void add_player(ClientConnection client, PlayerDesc player_desc)
+    {
+        player_desc.unique_id = client->id();
+
+        net::Message<GameMsgTypes> msg_send_id{};
+        msg_send_id.header.id = GameMsgTypes::ClientAssignId;
+        msg_send_id << player_desc.unique_id;
+        client->send(msg_send_id);
+
+        glm::vec2 player_pos{
+            glm::vec2{ player_desc.screen_info.width / 2.0f - player_desc.size.x / 2.0f,
+                       0 },
+        }; // position for player 2
+
+        if (!has_player_one_)
+        {
+            player_pos = glm::vec2{
+                player_desc.screen_info.width / 2.0f - player_desc.size.x / 2.0f,
+                player_desc.screen_info.height - player_desc.size.y
+            }; // Set the position for player 1
+
+            has_player_one_           = true;
+            player_desc.player_number = PlayerNumber::One;
+        }
+        else
+        {
+            player_desc.player_number = PlayerNumber::Two;
+            // Also add the ball now that we have 2 players
+            const glm::vec2 player_size{ 100.0f, 20.0f };
+
+            glm::vec2 player1_pos{ glm::vec2{
+                player_desc.screen_info.width / 2.0f - player_size.x / 2.0f,
+                player_desc.screen_info.height - player_size.y } };
+
+            glm::vec2 ball_pos{ player1_pos +
+                                glm::vec2{ player_size.x / 2.0f - ball_radius_,
+                                           -ball_radius_ * 2.0f } };
+
+            const BallDesc ball{ ball_radius_,
+                                 true,
+                                 ball_pos,
+                                 initial_ball_velocity_,
+                                 glm::vec2{ ball_radius_ * 2.0, ball_radius_ * 2.0 } };
+            ball_slot_ = balls_.add(ball,
+                                    glm::vec2{ player_desc.screen_info.width,
+                                               player_desc.screen_info.height });
+
+            allow_connections_ = false; // The match now has 2 players, prevent all
+                                        // further connections
+        }
+        player_desc.pos = player_pos;
+        screen_info_    = player_desc.screen_info;
+
+        clients_.insert_or_assign(player_desc.unique_id, client);
+
+        net::Message<GameMsgTypes> msg_add_player{};
+        msg_add_player.header.id = GameMsgTypes::GameAddPlayer;
+        msg_add_player << player_desc;
+        message_all_players(msg_add_player);
+
+        // Also update player's desc on the server
+        map_player_roster_.insert_or_assign(player_desc.unique_id, player_desc);
+        update_paddles();
+
+        for (const auto& player : map_player_roster_)
+        {
+            net::Message<GameMsgTypes> msg_add_other_players{};
+            msg_add_other_players.header.id = GameMsgTypes::GameAddPlayer;
+            msg_add_other_players << player.second;
+            client->send(msg_add_other_players);
+        }
+    }
+
+    void remove_player(u32 client_id)
+    {
+        if (!map_player_roster_.contains(client_id))
+        {
+            return;
+        }
+
+        std::cout << "[Match " << id_ << "] Removing " << client_id << "\n";
+        map_player_roster_.erase(client_id);
+        clients_.erase(client_id);
+        acked_snapshots_.erase(client_id);
+        input_states_.erase(client_id);
+        update_paddles();
+
+        net::Message<GameMsgTypes> msg_remove_player{};
+        msg_remove_player.header.id = GameMsgTypes::GameRemovePlayer;
+        msg_remove_player << client_id;
+        message_all_players(msg_remove_player);
+    }
+
+    void on_message(ClientConnection client, net::Message<GameMsgTypes>& msg)
+    {
+        switch (msg.header.id)
+        {
+        case GameMsgTypes::GamePlayerInput:
+        {
+            read_bytes(msg, input_bytes_);
+            const bool decoded{ gcom::decode_inputs(input_bytes_, input_commands_) };
+
+            // Only the sender's own paddle, a client can't move anyone else
+            auto it{ map_player_roster_.find(client->id()) };
+            if (decoded && it != map_player_roster_.end())
+            {
+                apply_inputs(it->second, input_commands_);
+            }
+
+            // The other client sees the new position in the next snapshot
+            break;
+        }
+        case GameMsgTypes::GameSnapshotAck:
+        {
+            if (msg.size() < sizeof(u16))
+            {
+                break;
+            }
+
+            u16 sequence{ 0 };
+            msg >> sequence;
+            if (clients_.contains(client->id()))
+            {
+                acked_snapshots_.insert_or_assign(client->id(), sequence);
+            }
+            break;
+        }
+        case GameMsgTypes::GamePlayerLaunchBall:
+        {
+            if (ball_slot_)
+            {
+                balls_.set_stuck(*ball_slot_, false);
+            }
+            break;
+        }
+        case GameMsgTypes::GamePlayerReady:
+        {
+            // Also update player's is_ready on the server
+            auto it{ map_player_roster_.find(client->id()) };
+            if (it != map_player_roster_.end())
+            {
+                it->second.is_ready = true;
+            }
+
+            bool player_one_ready{ false };
+            bool player_two_ready{ false };
+            for (const auto& [id, player] : map_player_roster_)
+            {
+                if (player.player_number == PlayerNumber::One && player.is_ready)
+                {
+                    player_one_ready = true;
+                }
+
+                if (player.player_number == PlayerNumber::Two && player.is_ready)
+                {
+                    player_two_ready = true;
+                }
+            }
+
+            if (player_one_ready && player_two_ready)
+            {
+                set_game_active(true);
+                net::Message<GameMsgTypes> msg_game_playing{};
+                msg_game_playing.header.id = GameMsgTypes::GameActive;
+                message_all_players(msg_game_playing);
+            }
+
+            break;
+        }
+        default:
+        {
+            break;
+        }
+        }
+    }
+
+    // Connections that dropped without unregistering leave the match here
+    void drop_disconnected()
+    {
+        for (auto it{ clients_.begin() }; it != clients_.end();)
+        {
+            const u32 client_id{ it->first };
+            const bool connected{ it->second && it->second->is_connected() };
+            ++it;
+            if (!connected)
+            {
+                remove_player(client_id);
+            }
+        }
+    }
+
+    // Called once per sim step, after the shard ran BallBatch::integrate() and
+    // BallBatch::collide_paddles()
+    void step(float dt)
+    {
+        match_time_ += dt;
+        if (!game_active_)
+        {
+            return;
+        }
+
+        resolve_paddle_hits();
+        update_lives();
+        check_game_over();
+    }
+
+    // Called once per tick after all the steps. Events the steps produced are kept
+    // until a tick that sends a snapshot.
+    void end_tick(bool send_snapshot)
+    {
+        if (game_active_ && send_snapshot)
+        {
+            broadcast_game_state();
+        }
+    }
+
+  private:
+    void message_all_players(const net::Message<GameMsgTypes>& msg,
+                             ClientConnection ignore_client = nullptr)
+    {
+        for (const auto& [id, client] : clients_)
+        {
+            if (client && client != ignore_client && client->is_connected())
+            {
+                client->send(msg);
+            }
+        }
+    }
+
+    void set_game_active(bool active)
+    {
+        game_active_ = active;
+        if (ball_slot_)
+        {
+            balls_.set_active(*ball_slot_, active);
+        }
+    }
+
+    // Mirror the roster's pads into the batch, paddle n belongs to player n + 1
+    void update_paddles()
+    {
+        if (!ball_slot_)
+        {
+            return;
+        }
+
+        for (u32 paddle{ 0 }; paddle < gcom::BallBatch::PADDLES_PER_BALL; ++paddle)
+        {
+            balls_.clear_paddle(*ball_slot_, paddle);
+        }
+        for (const auto& [id, player] : map_player_roster_)
+        {
+            const u32 paddle{ paddle_index(player.player_number) };
+            if (paddle < gcom::BallBatch::PADDLES_PER_BALL)
+            {
+                balls_.set_paddle(*ball_slot_, paddle, player.pos, player.size);
+            }
+        }
+    }
+
+    // Runs the same paddle movement the client predicted. Each command may only use
+    // as much time as has really passed, so sending extra commands can't make a
+    // paddle faster than PADDLE_SPEED.
+    void apply_inputs(PlayerDesc& player,
+                      const std::vector<gcom::InputCommand>& commands)
+    {
+        InputState& input{ input_states_[player.unique_id] };
+
+        const auto now{ std::chrono::steady_clock::now() };
+        const float elapsed{
+            std::chrono::duration<float>{ now - input.last_refill }.count()
+        };
+        input.budget      = std::min(input.budget + elapsed, MAX_INPUT_BUDGET);
+        input.last_refill = now;
+
+        const float max_x{ player.screen_info.width - player.size.x };
+        for (const auto& command : commands)
+        {
+            // Resent because our ack hadn't reached the client yet
+            if (command.sequence <= input.last_sequence)
+            {
+                continue;
+            }
+
+            const float duration{ std::min(
+                std::min(command.duration_ms, gcom::MAX_INPUT_DURATION_MS) / 1000.0f,
+                input.budget) };
+            input.budget -= duration;
+            player.pos.x = gcom::apply_input(
+                player.pos.x, command.direction, duration, max_x);
+            input.last_sequence = command.sequence;
+        }
+        update_paddles();
+
+        if (ball_slot_ && balls_.get(*ball_slot_).stuck &&
+            player.player_number == PlayerNumber::One)
+        {
+            glm::vec2 ball_pos{ player.pos + glm::vec2{ player.size.x / 2.0f -
+                                                            ball_radius_,
+                                                        -ball_radius_ * 2.0f } };
+            balls_.set_pos(*ball_slot_, ball_pos);
+        }
+    }
+
+    static u32 paddle_index(PlayerNumber player_number)
+    {
+        return static_cast<u32>(player_number) - static_cast<u32>(PlayerNumber::One);
+    }
+
+    void resolve_paddle_hits()
+    {
+        if (!ball_slot_)
+        {
+            return;
+        }
+
+        const u8 hits{ balls_.hit_mask(*ball_slot_) };
+        if (hits == 0)
+        {
+            return;
+        }
+
+        BallDesc ball{ balls_.get(*ball_slot_) };
+        for (const auto& [id, player] : map_player_roster_)
+        {
+            if (!(hits & (1u << paddle_index(player.player_number))))
+            {
+                continue;
+            }
+
+            // check where it hit the board, and change velocity based on where it
+            // hit the board
+            float center_board{ player.pos.x + player.size.x / 2.0f };
+            float distance{ ball.pos.x + ball.radius - center_board };
+            float percentage{ distance / (player.size.x / 2.0f) };
+
+            // then move accordingly
+            float strength{ 2.0f };
+            glm::vec2 old_velocity{ ball.velocity };
+            ball.velocity.x = initial_ball_velocity_.x * percentage * strength;
+            ball.velocity.y = -1.0f * abs(ball.velocity.y); // avoid sticky paddle issue
+            if (player.player_number == PlayerNumber::One)
+            {
+                ball.velocity = glm::normalize(ball.velocity) * glm::length(old_velocity);
+            }
+            else
+            {
+                // Flip the velocity of the player 2 pad to shoot the ball downward
+                ball.velocity =
+                    glm::normalize(-ball.velocity) * glm::length(old_velocity);
+            }
+
+            // The sound is sent once per snapshot in broadcast_game_state(), no
+            // matter how many sim steps touched a paddle
+            pad_hit_ = true;
+        }
+        balls_.set_velocity(*ball_slot_, ball.velocity);
+    }
+
+    // reduce player 1 and 2 lives, clients see them in the next snapshot
+    void update_lives()
+    {
+        if (!ball_slot_)
+        {
+            return;
+        }
+
+        const BallDesc ball{ balls_.get(*ball_slot_) };
+        for (auto& [id, player] : map_player_roster_)
+        {
+            if (player.player_number == PlayerNumber::One &&
+                ball.pos.y >= player.screen_info.height - ball.size.y)
+            {
+                --player.lives;
+            }
+
+            if (player.player_number == PlayerNumber::Two && ball.pos.y <= 0)
+            {
+                --player.lives;
+            }
+        }
+    }
+
+    void check_game_over()
+    {
+        for (const auto& [id, player] : map_player_roster_)
+        {
+            if (map_player_roster_.size() <
+                MAX_PLAYERS) // If a player quits the game, the remaining player wins
+            {
+                broadcast_game_ends(player.player_number);
+                return;
+            }
+
+            if (player.player_number == PlayerNumber::One && player.lives <= 0)
+            {
+                broadcast_game_ends(PlayerNumber::Two);
+                return;
+            }
+
+            if (player.player_number == PlayerNumber::Two && player.lives <= 0)
+            {
+                broadcast_game_ends(PlayerNumber::One);
+                return;
+            }
+        }
+    }
+
+    void broadcast_game_ends(PlayerNumber winner)
+    {
+        net::Message<GameMsgTypes> msg_game_ends{};
+        msg_game_ends.header.id = GameMsgTypes::GameEnds;
+        winner_                 = winner;
+        msg_game_ends << winner_;
+        message_all_players(msg_game_ends);
+        set_game_active(false);
+        pad_hit_ = false;
+    }
+
+    void broadcast_game_state()
+    {
+        gcom::Snapshot snapshot{};
+        snapshot.sequence = next_snapshot_sequence_++;
+        snapshot.fields[gcom::Snapshot::SERVER_TIME_MS] =
+            static_cast<i32>(match_time_ * 1000.0);
+        if (pad_hit_)
+        {
+            snapshot.events |= gcom::Snapshot::EVENT_PAD_HIT;
+            pad_hit_ = false;
+        }
+        if (ball_slot_)
+        {
+            snapshot.set_ball(balls_.get(*ball_slot_));
+        }
+        for (const auto& [id, player] : map_player_roster_)
+        {
+            const u32 paddle{ paddle_index(player.player_number) };
+            if (paddle < gcom::Snapshot::PADDLE_COUNT)
+            {
+                snapshot.set_paddle(paddle, player.pos, player.lives);
+            }
+        }
+
+        for (const auto& [id, client] : clients_)
+        {
+            if (!client || !client->is_connected())
+            {
+                continue;
+            }
+
+            // Clients that haven't acked anything still in the history get a full
+            // snapshot
+            const gcom::Snapshot* baseline{ nullptr };
+            auto acked{ acked_snapshots_.find(id) };
+            if (acked != acked_snapshots_.end())
+            {
+                baseline = sent_snapshots_.find(acked->second);
+            }
+
+            auto input{ input_states_.find(id) };
+            snapshot.input_ack =
+                input != input_states_.end() ? input->second.last_sequence : 0;
+
+            snapshot_bytes_.clear();
+            gcom::encode_snapshot(snapshot, baseline, snapshot_bytes_);
+
+            net::Message<GameMsgTypes> msg_snapshot{};
+            msg_snapshot.header.id = GameMsgTypes::GameSnapshot;
+            write_bytes(msg_snapshot, snapshot_bytes_);
+            udp_.send(id, msg_snapshot);
+        }
+
+        sent_snapshots_.store(snapshot);
+    }
+
+  private:
+    const u32 id_;
+
+    std::unordered_map<u32, PlayerDesc> map_player_roster_{};
+    std::unordered_map<u32, ClientConnection> clients_{};
+    gcom::BallBatch& balls_;
+    udp::ServerChannel& udp_;
+    std::optional<gcom::BallBatch::Slot> ball_slot_{};
+    bool has_player_one_{ false };
+    const glm::vec2 initial_ball_velocity_{ 100.0f, -350.0f };
+    const float ball_radius_{ 12.5f };
+    ScreenInfo screen_info_{};
+
+    PlayerNumber winner_{ PlayerNumber::Zero };
+
+    // Events produced by the sim steps since the last snapshot
+    bool pad_hit_{ false };
+    double match_time_{ 0.0 }; // simulated seconds since the match was created
+
+    gcom::SnapshotHistory sent_snapshots_{};
+    std::unordered_map<u32, u16> acked_snapshots_{}; // client id -> sequence
+    u16 next_snapshot_sequence_{ 0 };
+    std::vector<u8> snapshot_bytes_{};                 // reused encode buffer
+    std::vector<u8> input_bytes_{};                    // reused decode buffer
+    std::vector<gcom::InputCommand> input_commands_{}; // reused decode buffer
+
+    struct InputState
+    {
+        u32 last_sequence{ 0 };
+        float budget{ 0.0f }; // seconds of movement the client may still use
+        std::chrono::steady_clock::time_point last_refill{};
+    };
+    std::unordered_map<u32, InputState> input_states_{}; // client id -> input
+    static constexpr float MAX_INPUT_BUDGET{ 0.25f };
+
+    bool game_active_{ false };
+    bool allow_connections_{ true };
+
+  public:
+    static constexpr size_t MAX_PLAYERS{ 2 };
+};
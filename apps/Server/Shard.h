@@ -0,0 +1,322 @@
+#pragma once
+
+#include <GameCommon/Types.h>
+#include <NetCommon/NetCommon.h>
+#include "../GameMsgTypes.h"
+#include "Match.h"
+#include <GameCommon/PlayerDesc.h>
+#include "NetCommon/NetMessage.h"
+#include <GameCommon/BallBatch.h>
+#include <GameCommon/MpscQueue.h>
+#include "../UdpChannel.h"
+
+#include <atomic>
+
+// A message routed to a shard, tagged with the connection it came from
+struct ShardMessage
+{
+    ClientConnection remote{ nullptr };
+    net::Message<GameMsgTypes> msg;
+};
+
+// A shard is one worker thread that owns a disjoint set of matches. It has its own
+// inbound queue and fixed-rate tick loop, so shards never share state with each
+// other: the router pins every connection to a single shard and the only thing it
+// hands over is the message itself. The balls of all the shard's matches are
+// stepped together in one BallBatch.
+class Shard
+{
+  public:
+    Shard(u32 tick_rate, u32 snapshot_rate, u32 max_matches, udp::ServerChannel& udp)
+        : udp_{ udp },
+          tick_rate_{ tick_rate },
+          fixed_dt_{ 1.0f / static_cast<float>(tick_rate) },
+          snapshot_interval_{ std::max(1u,
+                                       tick_rate / std::max(1u, snapshot_rate)) },
+          max_matches_{ max_matches }
+    {
+    }
+
+    ~Shard() { stop(); }
+
+    Shard(const Shard&)            = delete;
+    Shard& operator=(const Shard&) = delete;
+
+    void start()
+    {
+        running_ = true;
+        thread_  = std::thread{ [this]() { run(); } };
+    }
+
+    void stop()
+    {
+        running_ = false;
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    // Called from the router and UDP threads. When the shard is so far behind that
+    // its whole inbox is full, inputs and acks are dropped and counted: clients
+    // resend inputs until they are acked and the next ack replaces a lost one.
+    // Only reliable control messages wait for room, so a slow shard can still hold
+    // up the caller, but not for the high-frequency traffic.
+    void post(ClientConnection remote, net::Message<GameMsgTypes>&& msg)
+    {
+        const bool droppable{ msg.header.id == GameMsgTypes::GamePlayerInput ||
+                              msg.header.id == GameMsgTypes::GameSnapshotAck };
+        ShardMessage shard_msg{ std::move(remote), std::move(msg) };
+        while (!messages_in_.try_push(std::move(shard_msg)))
+        {
+            if (droppable)
+            {
+                dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Number of live matches, published for the router's load balancing
+    u32 match_count() const { return match_count_.load(std::memory_order_relaxed); }
+
+    bool is_full() const { return match_count() >= max_matches_; }
+
+  private:
+    // Fixed-rate loop: drain the inbound queue, step every ball and match once per
+    // elapsed fixed_dt_ and let each match broadcast its state every
+    // snapshot_interval_ steps.
+    void run()
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto tick_duration{ std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>{ 1.0 / tick_rate_ }) };
+
+        auto next_tick{ Clock::now() };
+        while (running_)
+        {
+            drain(MAX_MESSAGES_PER_TICK);
+            report_drops();
+
+            u32 steps{ 0 };
+            const auto now{ Clock::now() };
+            while (next_tick <= now && steps < MAX_STEPS_PER_TICK)
+            {
+                next_tick += tick_duration;
+                ++steps;
+            }
+            // We fell too far behind (e.g. the process was suspended), drop the
+            // backlog instead of spiralling
+            if (next_tick <= now)
+            {
+                next_tick = now + tick_duration;
+            }
+
+            tick(steps);
+
+            std::this_thread::sleep_until(next_tick);
+        }
+    }
+
+    void drain(size_t max_messages)
+    {
+        messages_in_.drain(
+            [this](ShardMessage& msg) { on_message(msg.remote, msg.msg); },
+            max_messages);
+    }
+
+    // At most once per DROP_REPORT_INTERVAL, and only when something was dropped
+    void report_drops()
+    {
+        const auto now{ std::chrono::steady_clock::now() };
+        if (now - last_drop_report_ < DROP_REPORT_INTERVAL)
+        {
+            return;
+        }
+        last_drop_report_ = now;
+
+        const u64 dropped{ dropped_messages_.load(std::memory_order_relaxed) };
+        if (dropped != reported_drops_)
+        {
+            std::cout << "[SHARD] Inbox full, dropped " << dropped - reported_drops_
+                      << " inputs and acks\n";
+            reported_drops_ = dropped;
+        }
+    }
+
+    void on_message(ClientConnection client, net::Message<GameMsgTypes>& msg)
+    {
+        switch (msg.header.id)
+        {
+        case GameMsgTypes::ClientRegisterWithServer:
+        {
+            PlayerDesc player_desc{ 0, 3, { 0.0f, 0.0f } };
+            msg >> player_desc;
+
+            if (client_matches_.contains(client->id()))
+            {
+                break; // Already playing
+            }
+
+            Match* match{ find_open_match() };
+            if (match)
+            {
+                match->add_player(client, player_desc);
+                client_matches_.insert_or_assign(client->id(), match->id());
+            }
+            else
+            {
+                net::Message<GameMsgTypes> msg_server_is_full{};
+                msg_server_is_full.header.id = GameMsgTypes::ServerIsFull;
+                client->send(msg_server_is_full);
+            }
+
+            break;
+        }
+        case GameMsgTypes::ClientUnregisterWithServer:
+        {
+            auto it{ client_matches_.find(client->id()) };
+            if (it != client_matches_.end())
+            {
+                auto match{ matches_.find(it->second) };
+                if (match != matches_.end())
+                {
+                    match->second->remove_player(client->id());
+                }
+                client_matches_.erase(it);
+            }
+            break;
+        }
+        default:
+        {
+            // Everything else is match traffic
+            auto it{ client_matches_.find(client->id()) };
+            if (it != client_matches_.end())
+            {
+                auto match{ matches_.find(it->second) };
+                if (match != matches_.end())
+                {
+                    match->second->on_message(client, msg);
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    void tick(u32 steps)
+    {
+        for (auto& [id, match] : matches_)
+        {
+            match->drop_disconnected();
+        }
+
+        for (u32 step{ 0 }; step < steps; ++step)
+        {
+            balls_.integrate(fixed_dt_);
+            balls_.collide_paddles();
+            for (auto& [id, match] : matches_)
+            {
+                match->step(fixed_dt_);
+            }
+        }
+
+        // Clients interpolate between snapshots, so they don't need one per step
+        steps_since_snapshot_ += steps;
+        const bool send_snapshot{ steps_since_snapshot_ >= snapshot_interval_ };
+        if (send_snapshot)
+        {
+            steps_since_snapshot_ = 0;
+        }
+
+        for (auto& [id, match] : matches_)
+        {
+            match->end_tick(send_snapshot);
+        }
+
+        // Matches whose players all left are destroyed, their seats are freed
+        std::erase_if(matches_,
+                      [](const auto& pair) { return pair.second->is_finished(); });
+        std::erase_if(client_matches_,
+                      [this](const auto& pair)
+                      {
+                          auto match{ matches_.find(pair.second) };
+                          return match == matches_.end() ||
+                                 !match->second->has_player(pair.first);
+                      });
+
+        match_count_.store(static_cast<u32>(matches_.size()),
+                           std::memory_order_relaxed);
+    }
+
+    // Matchmaking: the oldest match still waiting for players gets the next client.
+    // A new match is created when nobody is waiting, as long as we have room for it.
+    Match* find_open_match()
+    {
+        while (!matchmaking_queue_.empty())
+        {
+            auto it{ matches_.find(matchmaking_queue_.front()) };
+            if (it != matches_.end() && it->second->is_open() &&
+                !it->second->is_finished())
+            {
+                Match* match{ it->second.get() };
+                if (match->player_count() + 1 >= Match::MAX_PLAYERS)
+                {
+                    matchmaking_queue_.pop_front(); // This client fills it
+                }
+                return match;
+            }
+            matchmaking_queue_.pop_front();
+        }
+
+        if (matches_.size() >= max_matches_)
+        {
+            return nullptr;
+        }
+
+        // Match ids only need to be unique within the shard
+        const u32 match_id{ next_match_id_++ };
+        auto [it, inserted]{ matches_.emplace(
+            match_id, std::make_unique<Match>(match_id, balls_, udp_)) };
+        matchmaking_queue_.push_back(match_id);
+        match_count_.store(static_cast<u32>(matches_.size()),
+                           std::memory_order_relaxed);
+        return it->second.get();
+    }
+
+  private:
+    // Shared with the other shards, only used to post sends to its io thread
+    udp::ServerChannel& udp_;
+
+    // Only touched by the shard thread. The batch is declared first so it outlives
+    // the matches that hold slots in it
+    gcom::BallBatch balls_{};
+    std::unordered_map<u32, std::unique_ptr<Match>> matches_{};
+    std::unordered_map<u32, u32> client_matches_{}; // client id -> match id
+    std::deque<u32> matchmaking_queue_{};           // matches waiting for players
+    u32 next_match_id_{ 1 };
+
+    // Router and UDP threads -> shard hand-off, lock-free
+    gcom::MpscQueue<ShardMessage> messages_in_{ INBOX_CAPACITY };
+    std::atomic<u32> match_count_{ 0 };
+    std::atomic<u64> dropped_messages_{ 0 }; // inputs and acks, inbox was full
+    u64 reported_drops_{ 0 };                // shard thread only
+    std::chrono::steady_clock::time_point last_drop_report_{};
+
+    // Fixed simulation clock
+    const u32 tick_rate_;
+    const float fixed_dt_;
+    const u32 snapshot_interval_; // steps between two snapshot broadcasts
+    u32 steps_since_snapshot_{ 0 };
+
+    const u32 max_matches_;
+
+    std::thread thread_{};
+    std::atomic<bool> running_{ false };
+
+    static constexpr size_t MAX_MESSAGES_PER_TICK{ 65535 };
+    static constexpr size_t INBOX_CAPACITY{ 16384 };
+    static constexpr u32 MAX_STEPS_PER_TICK{ 8 };
+    static constexpr std::chrono::seconds DROP_REPORT_INTERVAL{ 5 };
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <GameCommon/Types.h>
+#include <NetCommon/NetCommon.h>
+#include "GameMsgTypes.h"
+#include "NetCommon/NetMessage.h"
+
+// net::Message only streams fixed-size values and pops them back in reverse order.
+// An encoded snapshot is pushed byte by byte followed by its length, so the reader
+// pops the length first and then fills the bytes from the back.
+inline void write_bytes(net::Message<GameMsgTypes>& msg, const std::vector<u8>& bytes)
+{
+    for (const u8 byte : bytes)
+    {
+        msg << byte;
+    }
+    msg << static_cast<u16>(bytes.size());
+}
+
+// Replaces the contents of `bytes`, so a buffer reused across messages stops
+// allocating once it has grown to the largest message
+inline void read_bytes(net::Message<GameMsgTypes>& msg, std::vector<u8>& bytes)
+{
+    // net::Message doesn't check sizes, popping from a shorter body reads past it
+    if (msg.size() < sizeof(u16))
+    {
+        bytes.clear();
+        return;
+    }
+
+    u16 count{ 0 };
+    msg >> count;
+    if (count > msg.size())
+    {
+        bytes.clear();
+        return;
+    }
+
+    bytes.resize(count);
+    for (size_t i{ count }; i > 0; --i)
+    {
+        msg >> bytes[i - 1];
+    }
+}
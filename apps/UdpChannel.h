@@ -0,0 +1,450 @@
+#pragma once
+
+#include <GameCommon/Types.h>
+#include <NetCommon/NetCommon.h>
+#include "GameMsgTypes.h"
+#include "NetCommon/NetConnection.h"
+#include "NetCommon/NetMessage.h"
+
+#include <asio.hpp>
+#include <functional>
+
+// High-frequency state (snapshots, paddle updates, acks) goes over UDP next to the
+// NetCommon TCP connection, so one lost packet only costs one update instead of
+// stalling everything queued behind it. Only latest-state-wins messages may use it:
+// datagrams can be lost, and late ones are dropped rather than applied out of
+// order. Reliable events stay on TCP.
+//
+// Every socket operation runs on the channel's own io thread, other threads only
+// post work to it.
+namespace udp
+{
+// Every datagram starts with this, followed by the message body
+struct DatagramHeader
+{
+    u32 token;    // handed out over TCP, identifies and authenticates the client
+    u32 sequence; // per sender, increases with every datagram
+    GameMsgTypes id;
+};
+
+constexpr size_t MAX_DATAGRAM_BYTES{ 1200 };
+
+inline std::shared_ptr<std::vector<u8>>
+write_datagram(const DatagramHeader& header, const net::Message<GameMsgTypes>& msg)
+{
+    auto bytes{ std::make_shared<std::vector<u8>>(sizeof(DatagramHeader) +
+                                                  msg.body.size()) };
+    std::memcpy(bytes->data(), &header, sizeof(DatagramHeader));
+    std::memcpy(
+        bytes->data() + sizeof(DatagramHeader), msg.body.data(), msg.body.size());
+    return bytes;
+}
+
+inline std::optional<DatagramHeader> read_datagram(std::span<const u8> bytes,
+                                                   net::Message<GameMsgTypes>& msg)
+{
+    if (bytes.size() < sizeof(DatagramHeader))
+    {
+        return std::nullopt;
+    }
+
+    DatagramHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(DatagramHeader));
+    msg.header.id = header.id;
+    msg.body.assign(bytes.begin() + sizeof(DatagramHeader), bytes.end());
+    msg.header.size = static_cast<u32>(msg.body.size());
+    return header;
+}
+
+// Remembers the newest sequence seen for each message type. Anything older is a
+// stale update that was overtaken on the way.
+class StaleFilter
+{
+  public:
+    bool accept(GameMsgTypes id, u32 sequence)
+    {
+        auto [it, inserted]{ latest_.try_emplace(id, sequence) };
+        if (inserted)
+        {
+            return true;
+        }
+        if (sequence <= it->second)
+        {
+            return false;
+        }
+        it->second = sequence;
+        return true;
+    }
+
+    void clear() { latest_.clear(); }
+
+  private:
+    std::unordered_map<GameMsgTypes, u32> latest_{};
+};
+
+// The io_context, socket and thread both ends share
+class Channel
+{
+  public:
+    Channel()          = default;
+    virtual ~Channel() = default;
+
+    Channel(const Channel&)            = delete;
+    Channel& operator=(const Channel&) = delete;
+
+  protected:
+    void start_thread()
+    {
+        receive();
+        thread_ = std::thread{ [this]() { context_.run(); } };
+    }
+
+    void stop_thread()
+    {
+        context_.stop();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        std::error_code ec{};
+        socket_.close(ec);
+        context_.restart();
+    }
+
+    // Only called on the io thread
+    void send_to(std::shared_ptr<std::vector<u8>> bytes,
+                 const asio::ip::udp::endpoint& endpoint)
+    {
+        socket_.async_send_to(asio::buffer(*bytes),
+                              endpoint,
+                              [bytes](std::error_code, size_t) {});
+    }
+
+    virtual void on_datagram(std::span<const u8> bytes,
+                             const asio::ip::udp::endpoint& sender) = 0;
+
+  private:
+    void receive()
+    {
+        socket_.async_receive_from(
+            asio::buffer(receive_buffer_),
+            sender_,
+            [this](std::error_code ec, size_t length)
+            {
+                if (ec == asio::error::operation_aborted || !socket_.is_open())
+                {
+                    return;
+                }
+                // Errors like ICMP port unreachable only concern one datagram
+                if (!ec)
+                {
+                    on_datagram(std::span<const u8>{ receive_buffer_.data(), length },
+                                sender_);
+                }
+                receive();
+            });
+    }
+
+  protected:
+    asio::io_context context_{};
+    asio::ip::udp::socket socket_{ context_ };
+
+  private:
+    std::thread thread_{};
+    std::array<u8, MAX_DATAGRAM_BYTES> receive_buffer_{};
+    asio::ip::udp::endpoint sender_{};
+};
+
+// Server end: one socket for every client. A client's endpoint is learnt from the
+// datagrams it sends, so it also follows NAT rebinding.
+class ServerChannel : public Channel
+{
+  public:
+    using ClientConnection = std::shared_ptr<net::Connection<GameMsgTypes>>;
+    // Called on the io thread with the client the datagram belongs to and the route
+    // it was registered with
+    using Handler =
+        std::function<void(ClientConnection, u32, net::Message<GameMsgTypes>&&)>;
+
+    explicit ServerChannel(Handler on_message) : on_message_{ std::move(on_message) }
+    {
+    }
+
+    ~ServerChannel() override { stop(); }
+
+    bool start(u16 port)
+    {
+        try
+        {
+            socket_.open(asio::ip::udp::v4());
+            socket_.bind(asio::ip::udp::endpoint{ asio::ip::udp::v4(), port });
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "[UDP] Exception: " << e.what() << "\n";
+            return false;
+        }
+
+        start_thread();
+        std::cout << "[UDP] Listening on port " << port << "\n";
+        return true;
+    }
+
+    void stop() { stop_thread(); }
+
+    void add_peer(ClientConnection client, u32 token, u32 route)
+    {
+        asio::post(context_,
+                   [this, client{ std::move(client) }, token, route]()
+                   {
+                       auto peer{ std::make_unique<Peer>() };
+                       peer->client = client;
+                       peer->token  = token;
+                       peer->route  = route;
+                       peer_tokens_.insert_or_assign(token, client->id());
+                       peers_.insert_or_assign(client->id(), std::move(peer));
+                   });
+    }
+
+    void remove_peer(u32 client_id)
+    {
+        asio::post(context_,
+                   [this, client_id]()
+                   {
+                       auto it{ peers_.find(client_id) };
+                       if (it != peers_.end())
+                       {
+                           peer_tokens_.erase(it->second->token);
+                           peers_.erase(it);
+                       }
+                   });
+    }
+
+    // Falls back to the client's TCP connection until its first datagram arrived
+    void send(u32 client_id, const net::Message<GameMsgTypes>& msg)
+    {
+        asio::post(context_,
+                   [this, client_id, msg]()
+                   {
+                       auto it{ peers_.find(client_id) };
+                       if (it == peers_.end())
+                       {
+                           return;
+                       }
+
+                       Peer& peer{ *it->second };
+                       if (!peer.endpoint)
+                       {
+                           peer.client->send(msg);
+                           return;
+                       }
+                       send_to(write_datagram(
+                                   { peer.token, peer.next_sequence++, msg.header.id },
+                                   msg),
+                               *peer.endpoint);
+                   });
+    }
+
+  private:
+    struct Peer
+    {
+        ClientConnection client{ nullptr };
+        u32 token{ 0 };
+        u32 route{ 0 };
+        std::optional<asio::ip::udp::endpoint> endpoint{};
+        u32 next_sequence{ 0 };
+        StaleFilter filter{};
+    };
+
+    void on_datagram(std::span<const u8> bytes,
+                     const asio::ip::udp::endpoint& sender) override
+    {
+        net::Message<GameMsgTypes> msg{};
+        std::optional<DatagramHeader> header{ read_datagram(bytes, msg) };
+        if (!header || !is_unreliable(header->id) || !has_payload(msg))
+        {
+            return;
+        }
+
+        auto token{ peer_tokens_.find(header->token) };
+        if (token == peer_tokens_.end())
+        {
+            return; // Unknown or spoofed sender
+        }
+        Peer& peer{ *peers_.at(token->second) };
+
+        if (!peer.filter.accept(header->id, header->sequence))
+        {
+            return;
+        }
+        peer.endpoint = sender;
+
+        if (header->id == GameMsgTypes::ClientUdpHello)
+        {
+            // Answer so the client knows the path works both ways
+            send_to(write_datagram(
+                        { peer.token, peer.next_sequence++, GameMsgTypes::ClientUdpHello },
+                        msg),
+                    sender);
+            return;
+        }
+
+        on_message_(peer.client, peer.route, std::move(msg));
+    }
+
+    // The only messages a client may send over UDP. Everything else, registering
+    // and unregistering above all, has to come over TCP so the router sees it.
+    static bool is_unreliable(GameMsgTypes id)
+    {
+        return id == GameMsgTypes::GamePlayerInput ||
+               id == GameMsgTypes::GameSnapshotAck ||
+               id == GameMsgTypes::ClientUdpHello;
+    }
+
+    // Malformed datagrams never reach a match. The body ends with a u16: the
+    // acked sequence, or the byte count write_bytes() put after the inputs.
+    static bool has_payload(const net::Message<GameMsgTypes>& msg)
+    {
+        switch (msg.header.id)
+        {
+        case GameMsgTypes::GameSnapshotAck:
+        {
+            return msg.body.size() >= sizeof(u16);
+        }
+        case GameMsgTypes::GamePlayerInput:
+        {
+            if (msg.body.size() < sizeof(u16))
+            {
+                return false;
+            }
+            u16 count{ 0 };
+            std::memcpy(&count, msg.body.data() + msg.body.size() - sizeof(u16),
+                        sizeof(u16));
+            return msg.body.size() >= sizeof(u16) + count;
+        }
+        default:
+        {
+            return true;
+        }
+        }
+    }
+
+  private:
+    Handler on_message_;
+
+    // Only touched on the io thread
+    std::unordered_map<u32, std::unique_ptr<Peer>> peers_{}; // client id -> peer
+    std::unordered_map<u32, u32> peer_tokens_{};             // token -> client id
+};
+
+// Client end: talks to one server. Until the server answered a hello every send
+// goes over TCP instead.
+class ClientChannel : public Channel
+{
+  public:
+    ~ClientChannel() override { close(); }
+
+    bool open(const std::string& host, u16 port, u32 token)
+    {
+        close();
+        try
+        {
+            asio::ip::udp::resolver resolver{ context_ };
+            server_ = *resolver.resolve(host, std::to_string(port)).begin();
+            socket_.open(server_.protocol());
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "[UDP] Exception: " << e.what() << "\n";
+            return false;
+        }
+
+        token_ = token;
+        start_thread();
+        open_ = true;
+        return true;
+    }
+
+    void close()
+    {
+        open_      = false;
+        confirmed_ = false;
+        stop_thread();
+        next_sequence_ = 0;
+        filter_.clear();
+        last_hello_.reset();
+    }
+
+    // The server answered our hello, datagrams get through both ways
+    bool is_confirmed() const { return confirmed_; }
+
+    // Call once per frame, says hello until the server answers
+    void update()
+    {
+        if (!open_ || confirmed_)
+        {
+            return;
+        }
+
+        const auto now{ std::chrono::steady_clock::now() };
+        if (last_hello_ && now - *last_hello_ < HELLO_INTERVAL)
+        {
+            return;
+        }
+        last_hello_ = now;
+
+        net::Message<GameMsgTypes> msg_hello{};
+        msg_hello.header.id = GameMsgTypes::ClientUdpHello;
+        send(msg_hello);
+    }
+
+    void send(const net::Message<GameMsgTypes>& msg)
+    {
+        asio::post(context_,
+                   [this, msg]()
+                   {
+                       send_to(write_datagram({ token_, next_sequence_++, msg.header.id },
+                                              msg),
+                               server_);
+                   });
+    }
+
+    net::tsqueue<net::Message<GameMsgTypes>>& incoming() { return messages_in_; }
+
+  private:
+    void on_datagram(std::span<const u8> bytes,
+                     const asio::ip::udp::endpoint& sender) override
+    {
+        net::Message<GameMsgTypes> msg{};
+        std::optional<DatagramHeader> header{ read_datagram(bytes, msg) };
+        if (!header || header->token != token_ || sender != server_ ||
+            !filter_.accept(header->id, header->sequence))
+        {
+            return;
+        }
+
+        if (header->id == GameMsgTypes::ClientUdpHello)
+        {
+            confirmed_ = true;
+            return;
+        }
+        messages_in_.push_back(std::move(msg));
+    }
+
+  private:
+    asio::ip::udp::endpoint server_{};
+    u32 token_{ 0 };
+    std::atomic<bool> open_{ false };
+    std::atomic<bool> confirmed_{ false };
+    std::optional<std::chrono::steady_clock::time_point> last_hello_{};
+
+    // Only touched on the io thread
+    u32 next_sequence_{ 0 };
+    StaleFilter filter_{};
+
+    net::tsqueue<net::Message<GameMsgTypes>> messages_in_{};
+
+    static constexpr std::chrono::milliseconds HELLO_INTERVAL{ 250 };
+};
+} // namespace udp
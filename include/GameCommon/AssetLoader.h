@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Common.h"
+#include "AssetPack.h"
+#include "Shader.h"
+#include "TextRenderer.h"
+
+#include <atomic>
+
+namespace gcom
+{
+class GameLevel;
+
+// Loads the assets of a game at startup. Worker threads read the files, decode
+// the images, rasterize the font and parse the levels, while the thread with the
+// GL context only uploads and compiles what they finished, so it can keep
+// drawing a loading screen in between. Textures go up through a pixel buffer
+// object, and shaders compile on the driver's threads where it has them.
+// Everything ends up where ResourceManager::load_shader() and
+// load_texture(), TextRender::load() and GameLevel::load() would have put it.
+// Assets found in an AssetPack are taken from there instead of from their files.
+class AssetLoader
+{
+  public:
+    AssetLoader() = default;
+    // waits for the workers
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&)            = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Paths and names are kept as views, so like the names given to
+    // ResourceManager they have to outlive the loader
+    void add_shader(std::string_view vertex_file, std::string_view fragment_file,
+                    std::string_view geometry_file, std::string_view name);
+    void add_texture(std::string_view file, bool alpha, std::string_view name);
+    void add_font(std::string_view file, u32 font_size, TextRender& text);
+    // Levels are built after every texture is uploaded, their bricks look
+    // textures up by name
+    void add_level(std::string_view file, u32 level_width, u32 level_height,
+                   GameLevel& level);
+
+    // Takes what the pack has from it instead of from the files. The pack has to
+    // stay open until upload() returned true.
+    void use_pack(const AssetPack& pack);
+
+    // Starts decoding everything added so far. Nothing can be added afterwards.
+    // With 0 threads, upload() decodes each asset itself right before uploading
+    // it, the way loading worked before there was a loader.
+    void start(u32 threads = default_threads());
+
+    // Uploads what the workers have finished so far. Call it on the thread with
+    // the GL context until it returns true, then everything is loaded.
+    bool upload();
+
+    // Share of the assets uploaded, from 0 to 1
+    float progress() const;
+
+    // All cores but the one that uploads, at least one
+    static u32 default_threads();
+
+  private:
+    enum class Kind
+    {
+        Shader,
+        Texture,
+        Font,
+        Level,
+    };
+
+    struct ImageDeleter
+    {
+        void operator()(unsigned char* data) const;
+    };
+
+    // One asset, what to read and, once a worker is done, what it decoded
+    struct Job
+    {
+        Kind kind;
+        std::array<std::string_view, 3> files{}; // shaders use all three
+        std::string_view name{};
+        bool alpha{ false };
+        u32 size{ 0 }; // font size
+        u32 level_width{ 0 };
+        u32 level_height{ 0 };
+        TextRender* text{ nullptr };
+        GameLevel* level{ nullptr };
+
+        std::array<std::string, 3> sources{};
+        Shader shader{}; // compiling between upload() calls
+        std::unique_ptr<unsigned char, ImageDeleter> pixels{};
+        std::span<const u8> packed_pixels{}; // RGBA, in the pack
+        glm::ivec2 image_size{ 0 };
+        i32 channels{ 0 };
+        GlyphAtlas atlas{};
+        std::vector<std::vector<u32>> tiles{};
+        std::string error{}; // a shader file that couldn't be opened
+    };
+
+    std::vector<Job> jobs_{};
+    std::vector<std::thread> workers_{};
+    const AssetPack* pack_{ nullptr };
+
+    // next job a worker picks up
+    std::atomic<size_t> next_{ 0 };
+    // jobs decoded but not uploaded yet
+    std::mutex mutex_{};
+    std::vector<size_t> decoded_{};
+    std::vector<size_t> uploading_{}; // swapped with decoded_ by upload()
+    std::vector<size_t> waiting_levels_{};
+    std::vector<size_t> compiling_{}; // shaders the driver is still compiling
+
+    size_t textures_left_{ 0 };
+    size_t uploaded_{ 0 };
+    u32 pixel_buffer_{ 0 };
+
+    void decode(Job& job);
+    // false when the pack doesn't have the asset
+    bool decode_packed(Job& job);
+    void work();
+    // uploads a shader, texture or font
+    void upload(Job& job);
+    void upload_texture(Job& job);
+};
+} // namespace gcom
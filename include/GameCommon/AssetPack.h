@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Common.h"
+#include "TextRenderer.h"
+
+namespace gcom
+{
+// A single file holding the client's assets ready to use, written by the
+// AssetBake tool. Images are decoded RGBA, the font is rasterized into its atlas,
+// levels are tile grids and shaders and audio are kept as they are. The pack is
+// memory mapped, so nothing is read or parsed up front and an asset is used
+// straight from the mapping. Assets are looked up by the path the game loads
+// them from, e.g. "res/textures/ball.png".
+//
+// Layout, in the byte order of the machine that baked it:
+//   PackHeader
+//   PackEntry[entry_count]
+//   names, each followed by a 0 byte
+//   data of every entry, starting at multiples of PACK_ALIGNMENT
+class AssetPack
+{
+  public:
+    static constexpr std::array<char, 4> MAGIC{ 'P', 'N', 'P', 'K' };
+    static constexpr u32 VERSION{ 1 };
+    static constexpr u64 PACK_ALIGNMENT{ 16 };
+
+    enum class Kind : u32
+    {
+        Texture, // width x height RGBA pixels
+        Shader,  // GLSL source followed by a 0 byte
+        Font,    // FontGlyph[128] then the atlas, width x height, one byte each
+        Level,   // height rows, each its tile count and then its tile codes
+        Audio,   // the file's bytes, miniaudio decodes them
+    };
+
+    struct PackHeader
+    {
+        std::array<char, 4> magic;
+        u32 version;
+        u32 entry_count;
+        u32 names_size;
+    };
+
+    struct PackEntry
+    {
+        Kind kind;
+        u32 name_offset; // into the names
+        u32 name_size;   // without the 0 byte
+        u32 width;
+        u32 height;
+        u32 font_size;
+        u64 offset; // from the start of the pack
+        u64 size;
+    };
+
+    // A glyph of a Font entry, same as a Character
+    struct FontGlyph
+    {
+        std::array<float, 4> uv; // min x, min y, max x, max y
+        std::array<i32, 4> box;  // size x, size y, bearing x, bearing y
+        u32 advance;
+    };
+
+    struct Entry
+    {
+        Kind kind;
+        std::string_view name; // 0 terminated
+        u32 width;
+        u32 height;
+        u32 font_size;
+        std::span<const u8> data;
+    };
+
+    AssetPack() = default;
+    ~AssetPack();
+
+    AssetPack(const AssetPack&)            = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Maps the pack, false when there is none or it isn't a valid pack of this
+    // version. The game then loads the loose files instead.
+    bool open(std::string_view path);
+
+    bool is_open() const { return data_ != nullptr; }
+
+    // Null when the pack doesn't have the asset
+    const Entry* find(Kind kind, std::string_view name) const;
+
+    static FontGlyph to_glyph(const Character& character);
+    static Character to_character(const FontGlyph& glyph);
+
+    std::span<const Entry> entries() const { return entries_; }
+
+  private:
+    const u8* data_{ nullptr };
+    size_t size_{ 0 };
+#ifdef _WIN32
+    void* file_{ nullptr };
+    void* mapping_{ nullptr };
+#endif
+    std::vector<Entry> entries_{};
+
+    void close();
+};
+} // namespace gcom
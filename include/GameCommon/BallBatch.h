@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Types.h"
+#include "BallDesc.h"
+
+namespace gcom
+{
+// BallBatch steps many balls at once. All ball state lives in contiguous
+// structure-of-arrays storage so integrate() and collide_paddles() are plain loops
+// over floats that the compiler can vectorize, instead of one call per scattered
+// ball object. Every ball gets a stable slot and up to two paddles it can hit.
+class BallBatch
+{
+  public:
+    using Slot = u32;
+
+    static constexpr u32 PADDLES_PER_BALL{ 2 };
+
+    // allocates a slot for the ball, the ball can move inside [0, bounds]
+    Slot add(const BallDesc& ball, const glm::vec2& bounds);
+    // frees the slot, it will be reused by the next add()
+    void remove(Slot slot);
+
+    BallDesc get(Slot slot) const;
+    void set(Slot slot, const BallDesc& ball);
+
+    void set_pos(Slot slot, const glm::vec2& pos);
+    void set_velocity(Slot slot, const glm::vec2& velocity);
+    void set_stuck(Slot slot, bool stuck);
+    // inactive balls are neither moved nor tested against paddles
+    void set_active(Slot slot, bool active);
+
+    void set_paddle(Slot slot, u32 paddle, const glm::vec2& pos,
+                    const glm::vec2& size);
+    void clear_paddle(Slot slot, u32 paddle);
+
+    // moves every free ball by velocity * dt and reflects it off the bounds
+    void integrate(float dt);
+
+    // circle-vs-AABB test of every free ball against its paddles, swept along the
+    // last integrate() so a fast ball can't skip a paddle. A ball that went
+    // through a paddle is moved back to where it touched it. The result of the
+    // last call is available through hit_mask()
+    void collide_paddles();
+
+    // bit n is set when the ball touched paddle n in the last collide_paddles()
+    u8 hit_mask(Slot slot) const { return hits_[slot]; }
+
+    // number of slots, used or not
+    size_t capacity() const { return pos_x_.size(); }
+
+  private:
+    void update_moving(Slot slot);
+    // exact sweep for a ball collide_paddles() flagged in crossed_
+    void sweep_paddles(Slot slot);
+
+    // ball state
+    std::vector<float> pos_x_{};
+    std::vector<float> pos_y_{};
+    std::vector<float> prev_x_{}; // position before the last integrate()
+    std::vector<float> prev_y_{};
+    std::vector<float> step_x_{}; // the last integrate()'s move, ignoring bounds
+    std::vector<float> step_y_{};
+    std::vector<float> vel_x_{};
+    std::vector<float> vel_y_{};
+    std::vector<float> radius_{};
+    std::vector<float> max_x_{}; // bounds width - ball size
+    std::vector<float> max_y_{}; // bounds height - ball size
+    // 1.0f when the ball is active and not stuck, 0.0f otherwise. Kept as a float so
+    // the hot loops can blend with it instead of branching
+    std::vector<float> moving_{};
+    std::vector<u8> stuck_{};
+    std::vector<u8> active_{};
+
+    // paddle AABBs (center and half extents), one array per paddle index
+    using PaddleLane = std::array<std::vector<float>, PADDLES_PER_BALL>;
+    PaddleLane paddle_center_x_{};
+    PaddleLane paddle_center_y_{};
+    PaddleLane paddle_half_w_{};
+    PaddleLane paddle_half_h_{};
+    PaddleLane paddle_enabled_{};
+
+    std::vector<u8> hits_{};
+    // bit n is set when the ball's path crossed paddle n but it ended up past it
+    std::vector<u8> crossed_{};
+    std::vector<Slot> free_slots_{};
+};
+} // namespace gcom
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Types.h"
+
+namespace gcom
+{
+enum class Direction
+{
+    UP,
+    RIGHT,
+    DOWN,
+    LEFT,
+};
+
+using Collision = std::tuple<bool, Direction, glm::vec2>;
+
+// Which of the four directions `target` points closest to
+Direction vector_direction(const glm::vec2& target);
+
+// Boxes are given by their top-left corner and size like a GameObject
+bool check_collision(const glm::vec2& one_pos, const glm::vec2& one_size,
+                     const glm::vec2& two_pos, const glm::vec2& two_size);
+
+// Circle vs box. On a hit, also returns the side of the box it hit and the
+// vector from the circle's center to the closest point of the box.
+Collision check_collision(const glm::vec2& center, float radius,
+                          const glm::vec2& box_pos, const glm::vec2& box_size);
+
+// The ball's velocity after bouncing off the top of a paddle. The further from
+// the paddle's center it hits, the more it goes sideways, and its speed stays
+// the same. `ball_center_x` is where it hits, `base_speed_x` the sideways speed
+// of a ball that hits halfway between the center and the edge.
+glm::vec2 paddle_bounce(float ball_center_x, const glm::vec2& velocity,
+                        const glm::vec2& paddle_pos, const glm::vec2& paddle_size,
+                        float base_speed_x);
+} // namespace gcom
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Common.h"
+
+namespace gcom
+{
+// Counts the GL calls the renderers make, so the cost of a frame can be compared
+// between changes. Only the render thread touches it; reset it once per frame.
+struct GLCounters
+{
+    u64 draw_calls{ 0 };
+    u64 uniform_uploads{ 0 };  // glUniform* calls
+    u64 uniform_skips{ 0 };    // sets dropped because the value didn't change
+    u64 location_lookups{ 0 }; // glGetUniformLocation calls
+    u64 buffer_updates{ 0 };   // uniform buffer uploads
+
+    void reset() { *this = GLCounters{}; }
+};
+
+inline GLCounters gl_counters{};
+} // namespace gcom
@@ -2,13 +2,19 @@
 
 #include "GameLevel.h"
 #include "Common.h"
+#include "Collision.h"
+#include "AssetLoader.h"
 #include "GameObject.h"
 #include "BallObject.h"
 #include "PowerUp.h"
+#include "PowerUpKind.h"
+#include "ProgramCache.h"
+#include "ResourceRegistry.h"
 #include "ParticleGenerator.h"
 #include "PostProcessor.h"
 #include "ScreenInfo.h"
 #include "TextRenderer.h"
+#include "UniformBuffer.h"
 
 namespace gcom
 {
@@ -25,14 +31,6 @@ enum class GameState
     WAITING_FOR_OTHER_PLAYER
 };
 
-enum class Direction
-{
-    UP,
-    RIGHT,
-    DOWN,
-    LEFT,
-};
-
 enum class Winner
 {
     NoOne,
@@ -40,8 +38,6 @@ enum class Winner
     Player2,
 };
 
-using Collision = std::tuple<bool, Direction, glm::vec2>;
-
 class Game
 {
   public:
@@ -66,6 +62,10 @@ class Game
     virtual void render();
 
     virtual void do_collisions();
+    // Moves the ball back to the first brick or paddle it went through on its
+    // way from `from`, so do_collisions() resolves a hit a fast ball would have
+    // skipped. `velocity` is the ball's velocity before the move.
+    void sweep_ball(const glm::vec2& from, const glm::vec2& velocity, float dt);
 
     void spawn_powerups(GameObject& block);
     void active_powerup(const PowerUp& powerup);
@@ -74,6 +74,21 @@ class Game
     // Reset the sprite renderer before cleaning up other resources
     void shutdown();
 
+    // Creates the View uniform buffer every shader reads its projection from
+    void init_view_uniforms();
+
+    // Runs the loader until everything is uploaded, showing a progress bar
+    // meanwhile, and prints how long startup took. False if the window was
+    // closed first.
+    bool load_assets(AssetLoader& loader);
+
+    // Hands the sounds in the asset pack to miniaudio, so playing one of their
+    // files decodes it from the mapping. Call it right after ma_engine_init().
+    void register_packed_audio();
+
+    // "Lives <n>" without allocating, valid until the next call
+    std::string_view lives_text(u32 lives);
+
     GameState state_;
 
     static std::array<bool, 1024> keys_;
@@ -94,8 +109,10 @@ class Game
     bool check_collision(const GameObject& one, const GameObject& two);
 
     Collision check_collision(const BallObject& one, const GameObject& two);
-
-    Direction vector_direction(const glm::vec2& target);
+    // The box the ball can reach bricks in while do_collisions() resolves it.
+    // Resolving a hit pushes the ball back by up to its radius, so the ball's
+    // own box is grown by that much.
+    std::pair<glm::vec2, glm::vec2> collision_bounds(const BallObject& ball) const;
 
     // u32 width_;
     // u32 height_;
@@ -111,6 +128,7 @@ class Game
     Winner winner_{ Winner::NoOne };
 
     std::unique_ptr<SpriteRenderer> sprite_renderer_;
+    std::unique_ptr<SpriteBatch> sprite_batch_;
 
     std::unique_ptr<ParticleGenerator> particles_;
 
@@ -118,10 +136,25 @@ class Game
 
     std::unique_ptr<TextRender> text_;
 
+    // resolved by load_assets(), drawn or handed out every frame or message
+    Handle<Texture2D> background_texture_{};
+    Handle<Texture2D> paddle_texture_{};
+    std::array<Handle<Texture2D>, POWERUP_KINDS.size()> powerup_textures_{};
+
+    std::unique_ptr<UniformBuffer> view_uniforms_;
+
+    std::array<char, 16> lives_text_{};
+
     // Audio
     ma_result result_{};
     ma_engine engine_{};
 
+    // The engine decodes sounds straight from the mapping. ~Game() uninitializes
+    // it in its body, before any member is destroyed, so the pack outlives it
+    AssetPack pack_{};
+    static constexpr std::string_view PACK_FILE{ "res/assets.pack" };
+    static constexpr std::string_view PROGRAM_CACHE_DIRECTORY{ "shader_cache" };
+
   protected:
     float shake_time_{ 0.0f };
 
@@ -134,6 +167,13 @@ class Game
     // Radius of the ball_ object
     const float ball_radius_{ 12.5f };
 
+    // How far sweep_ball() leaves the ball inside what it hit, in pixels, so the
+    // overlap test in do_collisions() sees the contact
+    static constexpr float CONTACT_DEPTH{ 0.01f };
+
     const u32 font_size_{ 24 };
+
+    // when init() started, for the startup time load_assets() prints
+    std::chrono::steady_clock::time_point init_start_{};
 };
 } // namespace gcom
\ No newline at end of file
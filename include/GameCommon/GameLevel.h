@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "GameObject.h"
+#include "LevelTemplate.h"
 
 namespace gcom
 {
@@ -16,15 +17,26 @@ class GameLevel
 
     // Load level from file
     void load(std::string_view file, u32 level_width, u32 level_height);
+    // Load level from tile data, one row of tile codes per line of a level file
+    void load(const std::vector<std::vector<u32>>& tile_data, u32 level_width,
+              u32 level_height);
+
+    // Brings back every brick destroyed since load(). The layout is kept from
+    // load(), so this reads no file, allocates nothing and looks up no textures.
+    void reset();
+
+    // Indices into bricks of the bricks that can touch the box [min, max], in
+    // the order they appear in bricks. Valid until the next call.
+    std::span<const u32> bricks_near(const glm::vec2& min, const glm::vec2& max);
 
     // Check if the level is completed (all non-solid tiles are destroyed)
     bool is_completed();
 
     void draw(SpriteRenderer& renderer);
+    void draw(SpriteBatch& batch, u32 layer);
 
   private:
-    // Initialize level from tile data
-    void init(const std::vector<std::vector<u32>>& tile_data, u32 level_width,
-              u32 level_height);
+    LevelTemplate template_{};
+    std::vector<u32> nearby_{}; // reused by bricks_near()
 };
 } // namespace gcom
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Texture.h"
 #include "SpriteRenderer.h"
+#include "SpriteBatch.h"
 
 #include "Common.h"
 
@@ -23,6 +24,8 @@ class GameObject
 
     // draw sprite
     virtual void draw(SpriteRenderer& renderer);
+    // queue the sprite, it is drawn on the batch's next flush()
+    virtual void draw(SpriteBatch& batch, u32 layer);
 
     // Obj state
     glm::vec2 pos_;
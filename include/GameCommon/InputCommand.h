@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Types.h"
+
+namespace gcom
+{
+// Paddle speed in pixels per second, the client predicts with the same value the
+// server simulates with
+constexpr float PADDLE_SPEED{ 500.0f };
+
+// One frame of paddle input. The client applies it right away and sends it to the
+// server, which applies the same command to the authoritative paddle and acks the
+// last sequence it processed. Positions are never sent, so the server doesn't have
+// to trust them.
+struct InputCommand
+{
+    u32 sequence{ 0 }; // starts at 1, 0 means no input yet
+    u16 tick{ 0 };     // newest snapshot sequence the client had seen
+    i8 direction{ 0 }; // -1 left, 1 right
+    u8 duration_ms{ 0 };
+};
+
+// Longest frame one command can cover, longer frames are cut short
+constexpr u8 MAX_INPUT_DURATION_MS{ 100 };
+
+// Moves a paddle at pos_x by one command, keeping it inside [0, max_x]
+float apply_input(float pos_x, i8 direction, float duration, float max_x);
+
+// Appends commands with consecutive sequences to `out`. Inputs are resent until
+// acked, so one datagram usually carries a few of them.
+void encode_inputs(std::span<const InputCommand> commands, std::vector<u8>& out);
+
+// Replaces the contents of `out`, which the caller keeps between messages so its
+// capacity is reused. Returns false when the data is malformed.
+bool decode_inputs(std::span<const u8> in, std::vector<InputCommand>& out);
+} // namespace gcom
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Types.h"
+#include "TileGrid.h"
+
+namespace gcom
+{
+// A level read and laid out once: where its bricks are, how they look and which
+// tiles they stand on. It never changes afterwards, so restarting the level only
+// has to bring its bricks back instead of reading the level file again. Needs
+// only glm, GameLevel adds the textures the bricks are drawn with.
+class LevelTemplate
+{
+  public:
+    struct Brick
+    {
+        glm::vec2 pos;
+        glm::vec2 size;
+        glm::vec3 color;
+        bool solid; // indestructible
+    };
+
+    LevelTemplate() = default;
+    // Lays the tiles out over a level_width x level_height area, one row of tile
+    // codes per line of a level file
+    LevelTemplate(const std::vector<std::vector<u32>>& tile_data, u32 level_width,
+                  u32 level_height);
+
+    // The tile codes of a level file, one row per line
+    static std::vector<std::vector<u32>> read_tiles(std::string_view file);
+
+    std::span<const Brick> bricks() const { return bricks_; }
+    const TileGrid& grid() const { return grid_; }
+
+  private:
+    std::vector<Brick> bricks_{};
+    TileGrid grid_{};
+};
+} // namespace gcom
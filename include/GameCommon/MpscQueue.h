@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Types.h"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace gcom
+{
+// Bounded lock-free queue for many producer threads and one consumer thread.
+// Every cell carries a sequence number telling whose turn it is: producers claim
+// a cell by advancing tail_ with a CAS and publish it by bumping the sequence, the
+// consumer takes cells in order and hands them back one lap later. Nothing is
+// allocated after construction and nobody ever waits on a lock.
+template <typename T> class MpscQueue
+{
+  public:
+    // capacity must be a power of two
+    explicit MpscQueue(size_t capacity)
+        : cells_{ std::make_unique<Cell[]>(capacity) }, mask_{ capacity - 1 }
+    {
+        assert(capacity >= 2 && (capacity & mask_) == 0);
+        for (size_t i{ 0 }; i < capacity; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&)            = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread. Returns false and leaves `value` alone when the queue is full
+    bool try_push(T&& value)
+    {
+        size_t pos{ tail_.load(std::memory_order_relaxed) };
+        while (true)
+        {
+            Cell& cell{ cells_[pos & mask_] };
+            const size_t sequence{ cell.sequence.load(std::memory_order_acquire) };
+            const auto lap{ static_cast<std::ptrdiff_t>(sequence - pos) };
+            if (lap == 0)
+            {
+                if (tail_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lap < 0)
+            {
+                return false; // the consumer hasn't freed this cell yet
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed); // another producer won
+            }
+        }
+    }
+
+    // Consumer thread only. Calls fn(T&) on up to max_items pending items, oldest
+    // first, and returns how many it took. An item is released right after fn().
+    template <typename Fn> size_t drain(Fn&& fn, size_t max_items)
+    {
+        size_t count{ 0 };
+        while (count < max_items)
+        {
+            Cell& cell{ cells_[head_ & mask_] };
+            if (cell.sequence.load(std::memory_order_acquire) != head_ + 1)
+            {
+                break; // empty, or the next producer is still writing
+            }
+
+            fn(cell.value);
+            cell.value = T{};
+            cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+            ++head_;
+            ++count;
+        }
+        return count;
+    }
+
+    // Consumer thread only
+    bool empty() const
+    {
+        return cells_[head_ & mask_].sequence.load(std::memory_order_acquire) !=
+               head_ + 1;
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{ 0 };
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    const size_t mask_;
+
+    // Producers and the consumer each get their own cache line
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    alignas(64) size_t head_{ 0 };
+};
+} // namespace gcom
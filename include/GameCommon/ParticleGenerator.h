@@ -2,27 +2,25 @@
 
 #include "Common.h"
 #include "GameObject.h"
+#include "ParticlePool.h"
 #include "Texture.h"
 #include "Shader.h"
 
 namespace gcom
 {
-// Represents a single particle and its state
-struct Particle
-{
-    glm::vec2 pos{ 0.0f };
-    glm::vec2 velocity{ 0.0f };
-    glm::vec4 color{ 1.0f };
-    float life{ 0.0f };
-};
-
 // ParticleGenerator acts as a container for rendering a large number of
 // particles by repeatedly spawning and updating particles and killing
-// them after a given amount of time.
+// them after a given amount of time. The particles live in a ParticlePool, are
+// streamed into an instance buffer and drawn with one instanced draw call, so the
+// budget can go up to 100k particles.
 class ParticleGenerator
 {
   public:
     ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
+    ~ParticleGenerator();
+
+    ParticleGenerator(const ParticleGenerator&)            = delete;
+    ParticleGenerator& operator=(const ParticleGenerator&) = delete;
 
     // update all particles
     void update(float dt, GameObject& object, u32 new_particles,
@@ -31,21 +29,30 @@ class ParticleGenerator
     // render all particles
     void draw();
 
+    u32 live_count() const { return particles_.size(); }
+
   private:
+    // What the vertex shader reads per particle
+    struct Instance
+    {
+        glm::vec2 offset;
+        glm::vec4 color;
+    };
+
     // state
-    std::vector<Particle> particles_;
+    ParticlePool particles_;
     u32 amount_;
     // render state
     Shader shader_;
     Texture2D texture_;
-    u32 VAO_;
+    u32 VAO_{ 0 };
+    u32 quad_VBO_{ 0 };
+    u32 instance_VBO_{ 0 };
+    std::vector<Instance> instances_{}; // reused upload buffer
     // initializes buffer and vertext attributes
     void init();
-    // returns the 1st Particle index that's currently unused e.g. life <= 0.0f or 0
-    // if no particle is currently inactive
-    u32 first_unused_particle();
-    // respawn particle
-    void respawn_particle(Particle& particle, GameObject& object,
+    // spawn a particle next to the object
+    void respawn_particle(GameObject& object,
                           const glm::vec2& offset = glm::vec2{ 0.0f, 0.0f });
 };
 
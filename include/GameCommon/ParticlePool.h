@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Types.h"
+
+namespace gcom
+{
+// ParticlePool holds the particles of one generator in structure-of-arrays
+// storage. Live particles are packed at the front, so spawning appends at
+// size() and update() walks plain float arrays that the compiler can vectorize.
+// When the pool is full, spawn() overwrites the particles in turn.
+class ParticlePool
+{
+  public:
+    explicit ParticlePool(u32 capacity);
+
+    // O(1), returns the index the particle was written to
+    u32 spawn(const glm::vec2& pos, const glm::vec2& velocity, float shade);
+
+    // ages, moves and fades every live particle and drops the ones that died
+    void update(float dt);
+
+    // live particles are [0, size())
+    u32 size() const { return size_; }
+    u32 capacity() const { return capacity_; }
+
+    const float* pos_x() const { return pos_x_.data(); }
+    const float* pos_y() const { return pos_y_.data(); }
+    const float* shade() const { return shade_.data(); }
+    const float* alpha() const { return alpha_.data(); }
+    const float* life() const { return life_.data(); }
+
+  private:
+    // moves the last live particle into `index`
+    void remove(u32 index);
+
+    u32 capacity_;
+    u32 size_{ 0 };
+    u32 next_overwrite_{ 0 };
+
+    std::vector<float> pos_x_{};
+    std::vector<float> pos_y_{};
+    std::vector<float> vel_x_{};
+    std::vector<float> vel_y_{};
+    std::vector<float> shade_{}; // grey level, the same for r, g and b
+    std::vector<float> alpha_{};
+    std::vector<float> life_{};
+};
+} // namespace gcom
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <GameCommon/Common.h>
+#include <GameCommon/Types.h>
 #include <GameCommon/ScreenInfo.h>
 
 enum class PlayerNumber{
@@ -5,6 +5,7 @@
 #include "Texture.h"
 #include "SpriteRenderer.h"
 #include "Shader.h"
+#include "UniformBuffer.h"
 
 // PostProcessor hosts all PostProcessing effects for the game.
 // It renders the game on a textured quad after which one can
@@ -45,6 +46,7 @@ class PostProcessor
                       // MS color-buffer to texture
     u32 RBO_;         // RBO is used for multisampled color buffer
     u32 VAO_;
+    UniformBuffer effect_uniforms_;
     // initialize quad for rendering postprocessing texture
     void init_render_data();
 };
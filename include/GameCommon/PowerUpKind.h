@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Types.h"
+
+namespace gcom
+{
+// What a destroyed brick can drop. Each kind is rolled separately, so one brick
+// can drop several.
+struct PowerUpKind
+{
+    std::string_view type;
+    glm::vec3 color;
+    float duration; // seconds, 0.0f means it lasts forever
+    u32 chance;     // drops 1 in `chance` times
+    std::string_view texture;
+};
+
+inline constexpr std::array<PowerUpKind, 6> POWERUP_KINDS{ {
+    { "speed", glm::vec3{ 0.5f, 0.5f, 1.0f }, 0.0f, 75, "powerup_speed" },
+    { "sticky", glm::vec3{ 1.0f, 0.5f, 1.0f }, 20.0f, 75, "powerup_sticky" },
+    { "passthrough",
+      glm::vec3{ 0.5f, 1.0f, 0.5f },
+      10.0f,
+      75,
+      "powerup_passthrough" },
+    { "pad-size-increase",
+      glm::vec3{ 1.0f, 0.6f, 0.4f },
+      0.0f,
+      75,
+      "powerup_increase" },
+    // Negative powerups should spawn more often
+    { "confuse", glm::vec3{ 1.0f, 0.3f, 0.3f }, 15.0f, 15, "powerup_confuse" },
+    { "chaos", glm::vec3{ 0.9f, 0.25f, 0.25f }, 15.0f, 15, "powerup_chaos" },
+} };
+
+// Rolls for one kind of powerup
+bool should_spawn(const PowerUpKind& kind);
+} // namespace gcom
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Common.h"
+
+namespace gcom
+{
+// Linked shader programs saved with glGetProgramBinary(), so later runs load them
+// with glProgramBinary() instead of compiling their sources. A program is found
+// by a hash of its sources and of the driver's vendor, renderer and version, so
+// after editing a shader or updating the driver it is compiled again. The driver
+// may still reject a binary it wrote, then the program is compiled from source.
+// Shader::compile() and begin_compile() use the cache once it is open.
+class ProgramCache
+{
+  public:
+    // Keeps programs in `directory`, created on first use. Needs the GL context
+    // and does nothing when the driver can't return program binaries.
+    static void open(std::string_view directory);
+
+    static bool is_open() { return !directory_.empty(); }
+
+    // Names the program linked from these sources by this driver
+    static u64 key(std::string_view vertex_source, std::string_view fragment_source,
+                   std::string_view geometry_source);
+
+    // Puts the binary saved under the key into the program. False when there is
+    // none or the driver rejected it, the program can then be linked from source.
+    static bool load(u32 program, u64 key);
+
+    // Saves the linked program under the key
+    static void store(u32 program, u64 key);
+
+  private:
+    // private constructor, like ResourceManager everything here is static
+    explicit ProgramCache() {}
+
+    static std::string directory_;
+    // hash of the driver strings, where key() starts from
+    static u64 driver_key_;
+
+    static std::string path(u64 key);
+};
+} // namespace gcom
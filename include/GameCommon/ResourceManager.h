@@ -2,15 +2,17 @@
 
 #include "Texture.h"
 #include "Shader.h"
+#include "ResourceRegistry.h"
 
 namespace gcom
 {
 class ResourceManager
 {
   public:
-    // Resource storage
-    static std::map<std::string_view, Shader> shaders;
-    static std::map<std::string_view, Texture2D> textures;
+    // Resource storage. Code that runs every frame or every message resolves a
+    // handle once and gets resources through it, names are for setup code.
+    static ResourceRegistry<Shader> shaders;
+    static ResourceRegistry<Texture2D> textures;
 
     // loads (and generates) a shader program from file loading vertex, fragment (and
     // geometry) shader's source code. If gShaderFile is not "", it also loads a
@@ -19,15 +21,22 @@ class ResourceManager
                               std::string_view f_shader_file,
                               std::string_view g_shader_file, std::string_view name);
 
+    // Handle of a stored shader or texture, looked up once by name. Resources
+    // gotten through one are valid until the next one is added.
+    static Handle<Shader> shader_handle(std::string_view name);
+    static Handle<Texture2D> texture_handle(std::string_view name);
+
     // retrieves a stored shader
-    static Shader get_shader(std::string_view name);
+    static Shader& get_shader(Handle<Shader> handle);
+    static Shader& get_shader(std::string_view name);
 
     // loads (and generates) a texture from file
     static Texture2D load_texture(std::string_view file, bool alpha,
                                   std::string_view name);
 
     // retrieves a stored texture
-    static Texture2D get_texture(std::string_view name);
+    static const Texture2D& get_texture(Handle<Texture2D> handle);
+    static const Texture2D& get_texture(std::string_view name);
 
     // properly de-allocates all loaded resources
     static void clear();
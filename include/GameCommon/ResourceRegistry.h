@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Types.h"
+
+namespace gcom
+{
+template <typename T> class ResourceRegistry;
+
+// Index of a resource in a ResourceRegistry<T>, resolved from its name once, so
+// getting the resource is an array access. A default handle refers to nothing.
+template <typename T> class Handle
+{
+  public:
+    bool valid() const { return index_ != INVALID; }
+
+    bool operator==(const Handle&) const = default;
+
+  private:
+    friend class ResourceRegistry<T>;
+    static constexpr u32 INVALID{ std::numeric_limits<u32>::max() };
+    u32 index_{ INVALID };
+};
+
+// Resources of one type, stored in an array and named. Names are copied in when
+// a resource is first added or asked for, so callers don't have to keep their
+// strings alive. Resources are never removed, a handle stays valid as long as
+// the registry.
+template <typename T> class ResourceRegistry
+{
+  public:
+    // Adds the resource, or replaces the one with that name
+    Handle<T> set(std::string_view name, const T& resource)
+    {
+        const auto found{ indices_.find(name) };
+        if (found != indices_.end())
+        {
+            resources_[found->second] = resource;
+            return make_handle(found->second);
+        }
+        return add(name, resource);
+    }
+
+    // The handle of the resource with that name. Like operator[] of a map, a
+    // name nothing was added for gets a default constructed resource.
+    Handle<T> intern(std::string_view name)
+    {
+        const auto found{ indices_.find(name) };
+        return found != indices_.end() ? make_handle(found->second)
+                                       : add(name, T{});
+    }
+
+    // References are valid until the next resource is added
+    T& get(Handle<T> handle) { return resources_[handle.index_]; }
+    const T& get(Handle<T> handle) const { return resources_[handle.index_]; }
+
+    std::span<T> resources() { return resources_; }
+    std::span<const T> resources() const { return resources_; }
+    // in the same order as resources()
+    std::span<const std::string> names() const { return names_; }
+
+  private:
+    std::vector<T> resources_{};
+    std::vector<std::string> names_{};
+    // only used to intern names, never on the way to a resource
+    std::map<std::string, u32, std::less<>> indices_{};
+
+    static Handle<T> make_handle(u32 index)
+    {
+        Handle<T> handle{};
+        handle.index_ = index;
+        return handle;
+    }
+
+    Handle<T> add(std::string_view name, const T& resource)
+    {
+        const auto index{ static_cast<u32>(resources_.size()) };
+        resources_.push_back(resource);
+        names_.emplace_back(name);
+        indices_.emplace(names_.back(), index);
+        return make_handle(index);
+    }
+};
+} // namespace gcom
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <GameCommon/Common.h>
+#include <GameCommon/Types.h>
 
 struct ScreenInfo
 {
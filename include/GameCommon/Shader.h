@@ -4,6 +4,21 @@
 
 namespace gcom
 {
+// Handle to one uniform of a shader, resolved once with Shader::uniform<T>() so
+// setting it needs neither a name lookup nor glGetUniformLocation. T is the type
+// that gets uploaded. A handle for a uniform the shader doesn't have is valid to
+// use and sets nothing, like location -1 in GL.
+template <typename T> class Uniform
+{
+  public:
+    bool found() const { return index_ >= 0; }
+
+  private:
+    friend class Shader;
+    i32 index_{ -1 };
+};
+
+// Copies of a Shader share one program and so one uniform table
 class Shader
 {
   public:
@@ -11,12 +26,40 @@ class Shader
 
     // Sets the current shader as active
     Shader& use();
-    // compiles the shader from given source code
+    // compiles the shader from given source code, or loads it from the
+    // ProgramCache when that is open and has it
     void compile(std::string_view vertex_source, std::string_view fragment_source,
                  std::string_view geometry_source =
                      ""); // note: geometry source code is optional
 
-    // utils
+    // compile() in two halves. With GL_KHR_parallel_shader_compile the driver
+    // compiles on its own threads in between, and ready() tells when
+    // finish_compile() won't wait for it. The shader can't be used before that.
+    void begin_compile(std::string_view vertex_source,
+                       std::string_view fragment_source,
+                       std::string_view geometry_source = "");
+    bool ready() const;
+    void finish_compile();
+
+    // Looks the uniform up in the table built at link time. Names of array
+    // uniforms are given without the [0]
+    template <typename T> Uniform<T> uniform(std::string_view name) const
+    {
+        Uniform<T> handle{};
+        handle.index_ = find_uniform(name, gl_type_matches<T>);
+        return handle;
+    }
+
+    // Uploads the value unless the uniform already holds it. Like the setters
+    // below, this needs the shader in use
+    void set(Uniform<float> uniform, float value);
+    void set(Uniform<int> uniform, int value);
+    void set(Uniform<glm::vec2> uniform, const glm::vec2& value);
+    void set(Uniform<glm::vec3> uniform, const glm::vec3& value);
+    void set(Uniform<glm::vec4> uniform, const glm::vec4& value);
+    void set(Uniform<glm::mat4> uniform, const glm::mat4& value);
+
+    // utils, these resolve the name on every call; prefer handles in loops
     void set_float(std::string_view name, float value, bool use_shader = false);
     void set_integer(std::string_view name, int value, bool use_shader = false);
     void set_vector2f(std::string_view name, float x, float y,
@@ -37,7 +80,68 @@ class Shader
     u32 id{};
 
   private:
+    // An active uniform and the last value uploaded to it
+    struct UniformSlot
+    {
+        std::string name{};
+        i32 location{ -1 };
+        u32 type{ 0 };
+        std::array<float, 16> value{};
+        bool has_value{ false };
+    };
+
+    template <typename T> static bool gl_type_matches(u32 type);
+
+    std::shared_ptr<std::vector<UniformSlot>> uniforms_{
+        std::make_shared<std::vector<UniformSlot>>()
+    };
+
+    // vertex, fragment and geometry shader between begin_compile() and
+    // finish_compile(), all 0 when the program came from the ProgramCache
+    std::array<u32, 3> stages_{};
+    u64 cache_key_{ 0 };
+
+    // reads the active uniforms of the linked program into uniforms_
+    void reflect_uniforms();
+    // points the program's uniform blocks at their UniformBlock binding
+    void bind_uniform_blocks();
+    // returns -1 when there is no such uniform, asserts when the type is wrong
+    i32 find_uniform(std::string_view name, bool (*type_matches)(u32)) const;
+    // remembers the value and returns true when it differs from the last one
+    bool update_cache(i32 index, const void* value, size_t bytes);
+
     // checks if compilation or linking failed and if so, print the error logs
     void check_compile_errors(u32 object, std::string_view type);
 };
+
+template <> inline bool Shader::gl_type_matches<float>(u32 type)
+{
+    return type == GL_FLOAT;
+}
+
+// samplers and bools are set as ints
+template <> inline bool Shader::gl_type_matches<int>(u32 type)
+{
+    return type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_2D;
+}
+
+template <> inline bool Shader::gl_type_matches<glm::vec2>(u32 type)
+{
+    return type == GL_FLOAT_VEC2;
+}
+
+template <> inline bool Shader::gl_type_matches<glm::vec3>(u32 type)
+{
+    return type == GL_FLOAT_VEC3;
+}
+
+template <> inline bool Shader::gl_type_matches<glm::vec4>(u32 type)
+{
+    return type == GL_FLOAT_VEC4;
+}
+
+template <> inline bool Shader::gl_type_matches<glm::mat4>(u32 type)
+{
+    return type == GL_FLOAT_MAT4;
+}
 } // namespace gcom
\ No newline at end of file
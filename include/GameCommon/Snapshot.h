@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Types.h"
+#include "BallDesc.h"
+
+namespace gcom
+{
+// Positions and velocities go over the wire as fixed-point integers with
+// 1 / SNAPSHOT_SCALE pixel precision
+constexpr float SNAPSHOT_SCALE{ 8.0f };
+
+i32 quantize(float value);
+float dequantize(i32 value);
+
+// Everything a client needs to draw one tick of a match. Every field is a
+// quantized integer so a snapshot can be delta-encoded against an older one.
+struct Snapshot
+{
+    enum Field : u32
+    {
+        BALL_POS_X,
+        BALL_POS_Y,
+        BALL_VEL_X,
+        BALL_VEL_Y,
+        BALL_STUCK,
+        PADDLE_ONE_POS_X,
+        PADDLE_ONE_POS_Y,
+        PADDLE_ONE_LIVES,
+        PADDLE_TWO_POS_X,
+        PADDLE_TWO_POS_Y,
+        PADDLE_TWO_LIVES,
+        SERVER_TIME_MS, // since the match started, places the snapshot in time
+        FIELD_COUNT,
+    };
+
+    // Things that happened during the tick. They are not state, so they are never
+    // delta-encoded and are only sent in the snapshot of the tick they happened in
+    enum Event : u8
+    {
+        EVENT_PAD_HIT = 1 << 0,
+    };
+
+    static constexpr u32 PADDLE_COUNT{ 2 };
+    static constexpr u32 FIELDS_PER_PADDLE{ 3 };
+
+    u16 sequence{ 0 };
+    u8 events{ 0 };
+    // Last InputCommand the server applied for the receiving client. It differs per
+    // client, so it is sent as is and not delta-encoded
+    u32 input_ack{ 0 };
+    std::array<i32, FIELD_COUNT> fields{};
+
+    void set_ball(const BallDesc& ball);
+    // radius and size are constant and known to the client already
+    BallDesc ball(float radius, const glm::vec2& size) const;
+
+    // paddle 0 belongs to player one, paddle 1 to player two
+    void set_paddle(u32 paddle, const glm::vec2& pos, u32 lives);
+    glm::vec2 paddle_pos(u32 paddle) const;
+    u32 paddle_lives(u32 paddle) const;
+};
+
+// The last few snapshots, so either side can look up a delta baseline by sequence
+class SnapshotHistory
+{
+  public:
+    static constexpr u32 SIZE{ 32 };
+
+    void store(const Snapshot& snapshot);
+    // nullptr when the snapshot was never stored or has been overwritten since
+    const Snapshot* find(u16 sequence) const;
+    void clear();
+
+  private:
+    std::array<Snapshot, SIZE> snapshots_{};
+    std::array<bool, SIZE> used_{};
+};
+
+// Appends `current` to `out`, encoded as a delta against `baseline`. A null
+// baseline, or one too old to reference, encodes the full snapshot. Fields equal
+// to the baseline are left out and the rest are written as zigzag varints.
+void encode_snapshot(const Snapshot& current, const Snapshot* baseline,
+                     std::vector<u8>& out);
+
+// Rebuilds a snapshot written by encode_snapshot(). Returns nullopt when the data
+// is malformed or its baseline is no longer in `history`.
+std::optional<Snapshot> decode_snapshot(std::span<const u8> in,
+                                        const SnapshotHistory& history);
+} // namespace gcom
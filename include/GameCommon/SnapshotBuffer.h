@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Types.h"
+#include "Snapshot.h"
+
+namespace gcom
+{
+// Remote entities are drawn a little in the past, between two snapshots that have
+// both arrived already, so network jitter doesn't show up as stutter. Snapshots are
+// placed on the server's timeline through Snapshot::SERVER_TIME_MS, and the client
+// keeps a smoothed estimate of how far its own clock is ahead of that. Storage is a
+// fixed ring, pushing a snapshot never allocates.
+class SnapshotBuffer
+{
+  public:
+    static constexpr size_t SIZE{ 32 };
+
+    struct Sample
+    {
+        BallDesc ball;
+        std::array<glm::vec2, Snapshot::PADDLE_COUNT> paddles;
+    };
+
+    // now is the client's clock in seconds. Snapshots older than the newest one
+    // are ignored, unless the server time went back far enough to be a new match
+    void push(const Snapshot& snapshot, double now);
+
+    // The state `delay` seconds behind the estimated current server time. When the
+    // next snapshot is late the ball keeps moving along its velocity for at most
+    // `max_extrapolation` seconds, pass 0 to hold it in place instead. nullopt until
+    // the first snapshot arrived.
+    std::optional<Sample> sample(double now,
+                                 double delay,
+                                 double max_extrapolation,
+                                 float ball_radius,
+                                 const glm::vec2& ball_size) const;
+
+    void clear();
+
+  private:
+    static double server_time(const Snapshot& snapshot);
+    // i-th oldest snapshot
+    const Snapshot& at(size_t i) const { return snapshots_[(first_ + i) % SIZE]; }
+
+    std::array<Snapshot, SIZE> snapshots_{};
+    size_t first_{ 0 };
+    size_t count_{ 0 };
+    std::optional<double> clock_offset_{}; // client time - server time
+};
+} // namespace gcom
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Shader.h"
+#include "Common.h"
+#include "Texture.h"
+
+namespace gcom
+{
+// Collects sprites for a frame and draws them with one instanced draw call per
+// texture instead of one call per sprite. Sprites are grouped by layer first so
+// callers keep control over what ends up on top; within a layer they are drawn
+// in the order they were added. Takes the same arguments as
+// SpriteRenderer::draw_sprite() and needs the sprite_batch shader.
+class SpriteBatch
+{
+  public:
+    // Counters since the last begin_frame()
+    struct Stats
+    {
+        u32 sprites{ 0 };
+        u32 draw_calls{ 0 };
+        double cpu_ms{ 0.0 }; // spent sorting, uploading and issuing draws
+    };
+
+    explicit SpriteBatch(const Shader& shader);
+    ~SpriteBatch();
+
+    SpriteBatch(const SpriteBatch&)            = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+    void begin_frame();
+
+    void add(const Texture2D& texture, const glm::vec2& position,
+             const glm::vec2& size  = glm::vec2{ 10.0f, 10.0f },
+             float rotate           = 0.0f,
+             const glm::vec3& color = glm::vec3{ 1.0f },
+             u32 layer              = 0);
+
+    // Draws everything added since the last flush
+    void flush();
+
+    const Stats& stats() const { return stats_; }
+
+  private:
+    // What the vertex shader reads per instance
+    struct Instance
+    {
+        glm::vec4 rect;           // position, size
+        glm::vec4 color_rotation; // color, rotation in radians
+    };
+
+    struct Sprite
+    {
+        u32 layer;
+        u32 texture;
+        Instance instance;
+    };
+
+    Shader shader_;
+    u32 quad_VAO_{ 0 };
+    u32 quad_VBO_{ 0 };
+    u32 instance_VBO_{ 0 };
+    size_t instance_capacity_{ 0 }; // in instances
+
+    // Reused every frame
+    std::vector<Sprite> sprites_{};
+    std::vector<Instance> instances_{};
+
+    Stats stats_{};
+
+    void init_render_data();
+    void set_instance_offset(size_t first);
+};
+} // namespace gcom
@@ -19,6 +19,8 @@ class SpriteRenderer
 
   private:
     Shader shader_;
+    Uniform<glm::mat4> model_;
+    Uniform<glm::vec3> sprite_color_;
     u32 quad_VAO_;
 
     void init_render_data();
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Types.h"
+
+namespace gcom
+{
+// Continuous version of the circle-vs-AABB test. The circle's center moves in a
+// straight line from `from` to `to`, and the box is given by its top-left corner
+// and size like a GameObject. Returns the fraction of the move, in [0, 1], at
+// which the circle first touches the box, or nothing when it doesn't touch it
+// during the move. A circle that already touches the box at `from` is not
+// reported, so a ball that was just bounced off a box isn't caught by it again.
+std::optional<float> sweep_circle_box(const glm::vec2& from, const glm::vec2& to,
+                                      float radius, const glm::vec2& box_pos,
+                                      const glm::vec2& box_size);
+} // namespace gcom
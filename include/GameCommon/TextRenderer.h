@@ -7,36 +7,125 @@ namespace gcom
 // Holds all state information relevant to a character as loaded using FreeType
 struct Character
 {
-    u32 texture_id;     // ID handle of the glyph texture
-    glm::ivec2 size;    // size of glyph
-    glm::ivec2 bearing; // offset from baseline to left/top of glyph
-    u32 advance;        // horizontal offset to advance to next glyph
+    glm::vec2 uv_min{ 0.0f }; // top-left of the glyph in the atlas
+    glm::vec2 uv_max{ 0.0f }; // bottom-right of the glyph in the atlas
+    glm::ivec2 size{ 0 };     // size of glyph
+    glm::ivec2 bearing{ 0 };  // offset from baseline to left/top of glyph
+    u32 advance{ 0 };         // horizontal offset to advance to next glyph
 };
 
 
+// The glyphs of a font rasterized into one atlas image, before it goes to the GPU
+struct GlyphAtlas
+{
+    std::array<Character, 128> characters{}; // TextRender::GLYPH_COUNT of them
+    std::vector<u8> pixels{}; // one byte per texel, rows of `width`
+    i32 width{ 0 };
+    i32 height{ 0 };
+};
+
 // A renderer class for rendering text displayed by a font loaded using the
-// FreeType library. A single font is loaded, processed into a list of Character
-// items for later rendering.
+// FreeType library. A single font is loaded and its first 128 characters are
+// packed into one atlas texture. Text is collected into one vertex buffer, so a
+// whole string, or everything added before a flush(), is a single draw call.
+// Strings that repeat from frame to frame, like menus and the HUD, can be drawn
+// with draw_run() instead, which lays each one out once and keeps the vertices
+// on the GPU.
 class TextRender
 {
   public:
-    TextRender(u32 width, u32 height);
+    static constexpr u32 GLYPH_COUNT{ 128 };
+
+    // projects with the View uniform block, see Game::init_view_uniforms()
+    TextRender();
+    ~TextRender();
+
+    TextRender(const TextRender&)            = delete;
+    TextRender& operator=(const TextRender&) = delete;
 
     // pre-compiles a list of characters from the given font
     void load(std::string_view font, u32 font_size);
+    // uploads an atlas from rasterize()
+    void load(const GlyphAtlas& atlas);
+
+    // The CPU half of load(), touches no GL state and so can run on any thread
+    static GlyphAtlas rasterize(std::string_view font, u32 font_size);
+
+    // queues a string, nothing is drawn until flush()
+    void add_text(std::string_view text, float x, float y, float scale,
+                  const glm::vec3& color = glm::vec3(1.0f));
+
+    // draws everything queued since the last flush with one draw call
+    void flush();
+
+    // renders a string of text right away, same as add_text() and flush()
+    void render_text(std::string_view text, float x, float y, float scale,
+                     const glm::vec3& color = glm::vec3(1.0f));
 
-    // renders a string of text using the precompiled list of characters
-    void render_text(const std::string text, float x, float y, float scale,
-                     const glm::vec3 color = glm::vec3(1.0f));
+    // renders a string right away from the run cache. The first call for a text
+    // and scale lays it out and uploads it, later calls only draw it, wherever
+    // and in whatever color. Loading a font empties the cache.
+    void draw_run(std::string_view text, float x, float y, float scale,
+                  const glm::vec3& color = glm::vec3(1.0f));
 
-    // holds a list of pre-compiled Characters
-    std::map<char, Character> characters_;
+    size_t cached_run_count() const;
+
+    // holds the pre-compiled Characters, indexed by ASCII code
+    std::array<Character, GLYPH_COUNT> characters_{};
     // shader used for text rendering
     Shader shader_;
 
   private:
+    struct Vertex
+    {
+        glm::vec4 pos_uv; // <vec2 pos, vec2 tex>
+        glm::vec3 color;
+    };
+
+    // a laid out string in run_VBO_
+    struct Run
+    {
+        i32 first;
+        i32 count;
+    };
+
+    // lets the run maps be searched with a string_view, without a std::string
+    struct StringHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const
+        {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+    using RunMap = std::unordered_map<std::string, Run, StringHash, std::equal_to<>>;
+
+    // vertices in run_VBO_, about 2700 glyphs. When full the cache starts over
+    static constexpr i32 RUN_CAPACITY{ 16384 };
+
     // render state
     u32 VAO_;
     u32 VBO_;
+    u32 atlas_{ 0 };
+    size_t vertex_capacity_{ 0 }; // in vertices
+    std::vector<Vertex> vertices_{};
+    float cap_height_{ 0.0f }; // bearing of 'H', lines up the glyphs of a line
+
+    // run cache, one map per scale
+    u32 run_VAO_{ 0 };
+    u32 run_VBO_{ 0 };
+    i32 run_vertices_used_{ 0 };
+    std::vector<std::pair<float, RunMap>> runs_{};
+    std::vector<Vertex> run_layout_{}; // reused while laying out a new run
+
+    Uniform<glm::vec2> origin_{};
+    Uniform<glm::vec3> tint_{};
+
+    // appends the glyph quads of text to out, starting at x, y
+    void layout(std::string_view text, float x, float y, float scale,
+                const glm::vec3& color, std::vector<Vertex>& out) const;
+    // points the vertex attributes of the bound VAO at the bound buffer
+    static void set_vertex_attributes();
+    const Run& find_or_add_run(std::string_view text, float scale);
 };
 } // namespace gcom
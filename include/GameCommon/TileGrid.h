@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Types.h"
+
+namespace gcom
+{
+// TileGrid maps the tiles of a level to the bricks standing on them. Levels are
+// uniform grids, so the tiles a box overlaps follow from its corners and a
+// collision query only has to look at those instead of at every brick.
+class TileGrid
+{
+  public:
+    static constexpr u32 EMPTY{ std::numeric_limits<u32>::max() };
+
+    TileGrid() = default;
+    TileGrid(u32 columns, u32 rows, const glm::vec2& tile_size);
+
+    void set(u32 column, u32 row, u32 brick);
+
+    // Replaces `bricks` with the bricks on the tiles overlapping [min, max],
+    // row by row, so they come out in the order GameLevel::init() added them
+    void query(const glm::vec2& min, const glm::vec2& max,
+               std::vector<u32>& bricks) const;
+
+    u32 columns() const { return columns_; }
+    u32 rows() const { return rows_; }
+
+  private:
+    u32 columns_{ 0 };
+    u32 rows_{ 0 };
+    glm::vec2 tile_size_{ 1.0f };
+    std::vector<u32> tiles_{}; // row major, EMPTY or an index into the bricks
+};
+} // namespace gcom
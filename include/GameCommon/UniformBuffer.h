@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Common.h"
+
+namespace gcom
+{
+// Binding points of the uniform blocks shaders may declare. Shader::compile()
+// binds every block it finds by name, so one buffer bound to a point is seen by
+// all shaders and changing it is a single buffer update.
+enum class UniformBlock : u32
+{
+    View    = 0, // per view data, used by every 2D shader
+    Effects = 1, // post-processing kernels
+};
+
+// name of the block in GLSL
+std::string_view uniform_block_name(UniformBlock block);
+
+// Layout of the "View" block (std140)
+struct ViewUniforms
+{
+    glm::mat4 projection{ 1.0f };
+};
+
+// std140 pads every element of an array to 16 bytes
+template <typename T> struct alignas(16) Std140Element
+{
+    T value{};
+};
+
+// Layout of the "Effects" block in postprocessing.frag (std140)
+struct EffectUniforms
+{
+    std::array<Std140Element<glm::vec2>, 9> offsets{};
+    std::array<Std140Element<i32>, 9> edge_kernel{};
+    std::array<Std140Element<float>, 9> blur_kernel{};
+};
+
+static_assert(sizeof(ViewUniforms) == 64 && sizeof(EffectUniforms) == 3 * 9 * 16,
+              "uniform block layouts must match std140");
+
+// A uniform buffer bound to one of the UniformBlock points for its lifetime
+class UniformBuffer
+{
+  public:
+    UniformBuffer(UniformBlock block, size_t size);
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&)            = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    // replaces the contents, `size` must be the size the buffer was made with
+    void update(const void* data, size_t size);
+
+    template <typename T> void update(const T& value) { update(&value, sizeof(T)); }
+
+  private:
+    u32 id_{ 0 };
+    size_t size_;
+};
+} // namespace gcom
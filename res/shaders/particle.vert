@@ -1,12 +1,15 @@
 #version 400 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 tex_coords>
+layout (location = 1) in vec2 offset; // per particle
+layout (location = 2) in vec4 color;  // per particle
 
 out vec2 tex_coords;
 out vec4 particle_color;
 
-uniform mat4 projection;
-uniform vec2 offset;
-uniform vec4 color;
+layout (std140) uniform View
+{
+    mat4 projection;
+};
 
 void main()
 {
@@ -14,4 +17,4 @@ void main()
     tex_coords = vertex.zw;
     particle_color = color; 
     gl_Position = projection * vec4((vertex.xy * scale) + offset, 0.0, 1.0);
-}
\ No newline at end of file
+}
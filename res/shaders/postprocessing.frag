@@ -3,9 +3,13 @@ in vec2 tex_coords;
 out vec4 color;
 
 uniform sampler2D scene;
-uniform vec2 offsets[9];
-uniform int edge_kernel[9];
-uniform float blur_kernel[9];
+
+layout (std140) uniform Effects
+{
+    vec2 offsets[9];
+    int edge_kernel[9];
+    float blur_kernel[9];
+};
 
 uniform bool chaos;
 uniform bool confuse;
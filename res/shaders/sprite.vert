@@ -5,7 +5,11 @@ out vec2 tex_coords;
 
 uniform mat4 model;
 
-uniform mat4 projection;
+layout (std140) uniform View
+{
+    mat4 projection;
+};
+
 void main()
 {
     tex_coords = vertex.zw;
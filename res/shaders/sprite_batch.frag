@@ -0,0 +1,11 @@
+#version 400 core
+in vec2 tex_coords;
+in vec3 sprite_color;
+out vec4 color;
+
+uniform sampler2D image;
+
+void main()
+{
+    color = vec4(sprite_color, 1.0) * texture(image, tex_coords);
+}
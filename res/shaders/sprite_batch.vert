@@ -0,0 +1,27 @@
+#version 400 core
+layout (location = 0) in vec4 vertex;         // <vec2 position, vec2 tex_coords>
+layout (location = 1) in vec4 rect;           // per instance: <vec2 position, vec2 size>
+layout (location = 2) in vec4 color_rotation; // per instance: <vec3 color, radians>
+
+out vec2 tex_coords;
+out vec3 sprite_color;
+
+layout (std140) uniform View
+{
+    mat4 projection;
+};
+
+void main()
+{
+    // Same transform as SpriteRenderer's model matrix: scale, rotate around the
+    // center of the quad, then move it into place
+    vec2 local = (vertex.xy - 0.5) * rect.zw;
+    float c = cos(color_rotation.w);
+    float s = sin(color_rotation.w);
+    vec2 world = vec2(c * local.x - s * local.y, s * local.x + c * local.y) +
+                 rect.xy + 0.5 * rect.zw;
+
+    tex_coords = vertex.zw;
+    sprite_color = color_rotation.rgb;
+    gl_Position = projection * vec4(world, 0.0, 1.0);
+}
@@ -1,9 +1,9 @@
 #version 400 core
 in vec2 tex_coords;
+in vec3 text_color;
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 text_color;
 
 void main()
 {
@@ -1,11 +1,21 @@
 #version 400 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in vec3 color;
 out vec2 tex_coords;
+out vec3 text_color;
 
-uniform mat4 projection;
+layout (std140) uniform View
+{
+    mat4 projection;
+};
+
+// cached runs are laid out at the origin in white, see TextRender::draw_run()
+uniform vec2 origin;
+uniform vec3 tint;
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+    gl_Position = projection * vec4(vertex.xy + origin, 0.0, 1.0);
     tex_coords = vertex.zw;
-}
\ No newline at end of file
+    text_color = color * tint;
+}
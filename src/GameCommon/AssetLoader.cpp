@@ -0,0 +1,445 @@
+#include <GameCommon/AssetLoader.h>
+#include <GameCommon/Common.h>
+#include <GameCommon/GameLevel.h>
+#include <GameCommon/ResourceManager.h>
+
+#include <cstring>
+
+namespace
+{
+// Whole file into a string, false when it can't be opened
+bool read_file(std::string_view file, std::string& contents)
+{
+    std::ifstream stream{ file.data() };
+    if (!stream.is_open())
+    {
+        return false;
+    }
+    std::stringstream buffer{};
+    buffer << stream.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+} // namespace
+
+void gcom::AssetLoader::ImageDeleter::operator()(unsigned char* data) const
+{
+    stbi_image_free(data);
+}
+
+gcom::AssetLoader::~AssetLoader()
+{
+    // nothing is left for the workers once they ran out of jobs, so stop them
+    // early by using those up
+    next_ = jobs_.size();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+    if (pixel_buffer_ != 0)
+    {
+        glDeleteBuffers(1, &pixel_buffer_);
+    }
+}
+
+void gcom::AssetLoader::add_shader(std::string_view vertex_file,
+                                   std::string_view fragment_file,
+                                   std::string_view geometry_file,
+                                   std::string_view name)
+{
+    Job job{ Kind::Shader };
+    job.files = { vertex_file, fragment_file, geometry_file };
+    job.name  = name;
+    jobs_.push_back(std::move(job));
+}
+
+void gcom::AssetLoader::add_texture(std::string_view file, bool alpha,
+                                    std::string_view name)
+{
+    Job job{ Kind::Texture };
+    job.files[0] = file;
+    job.alpha    = alpha;
+    job.name     = name;
+    jobs_.push_back(std::move(job));
+    ++textures_left_;
+}
+
+void gcom::AssetLoader::add_font(std::string_view file, u32 font_size,
+                                 TextRender& text)
+{
+    Job job{ Kind::Font };
+    job.files[0] = file;
+    job.size     = font_size;
+    job.text     = &text;
+    jobs_.push_back(std::move(job));
+}
+
+void gcom::AssetLoader::add_level(std::string_view file, u32 level_width,
+                                  u32 level_height, GameLevel& level)
+{
+    Job job{ Kind::Level };
+    job.files[0]     = file;
+    job.level_width  = level_width;
+    job.level_height = level_height;
+    job.level        = &level;
+    jobs_.push_back(std::move(job));
+}
+
+void gcom::AssetLoader::use_pack(const AssetPack& pack) { pack_ = &pack; }
+
+void gcom::AssetLoader::start(u32 threads)
+{
+    // Shaders first, they are read quickly and the driver can compile them while
+    // the textures upload. Then the big images, they take longest to decode.
+    std::stable_sort(jobs_.begin(),
+                     jobs_.end(),
+                     [](const Job& a, const Job& b) { return a.kind < b.kind; });
+    decoded_.reserve(jobs_.size());
+    uploading_.reserve(jobs_.size());
+    compiling_.reserve(jobs_.size());
+    if (GLAD_GL_KHR_parallel_shader_compile)
+    {
+        // as many compiler threads as the driver wants to use
+        glMaxShaderCompilerThreadsKHR(std::numeric_limits<u32>::max());
+    }
+    for (u32 i{ 0 }; i < threads; ++i)
+    {
+        workers_.emplace_back([this]() { work(); });
+    }
+}
+
+void gcom::AssetLoader::work()
+{
+    for (size_t i{ next_++ }; i < jobs_.size(); i = next_++)
+    {
+        decode(jobs_[i]);
+        std::scoped_lock lock{ mutex_ };
+        decoded_.push_back(i);
+    }
+}
+
+void gcom::AssetLoader::decode(Job& job)
+{
+    if (decode_packed(job))
+    {
+        return;
+    }
+
+    switch (job.kind)
+    {
+    case Kind::Shader:
+        for (size_t i{ 0 }; i < job.files.size(); ++i)
+        {
+            // the geometry shader is optional
+            if (!job.files[i].empty() && !read_file(job.files[i], job.sources[i]))
+            {
+                job.error = job.files[i];
+            }
+        }
+        break;
+    case Kind::Texture:
+    {
+        // Ask for exactly the channels the texture format expects, the pixel
+        // buffer holds no more than that
+        int width{};
+        int height{};
+        int nr_channels{};
+        job.channels = job.alpha ? 4 : 3;
+        job.pixels.reset(stbi_load(
+            job.files[0].data(), &width, &height, &nr_channels, job.channels));
+        job.image_size = job.pixels ? glm::ivec2{ width, height } : glm::ivec2{ 0 };
+        break;
+    }
+    case Kind::Font:
+        job.atlas = TextRender::rasterize(job.files[0], job.size);
+        break;
+    case Kind::Level:
+        job.tiles = LevelTemplate::read_tiles(job.files[0]);
+        break;
+    }
+}
+
+// Everything in the pack is ready to use, this only checks it has the expected
+// size and copies what the uploads want in a different container
+bool gcom::AssetLoader::decode_packed(Job& job)
+{
+    using PackKind = AssetPack::Kind;
+    if (!pack_)
+    {
+        return false;
+    }
+
+    switch (job.kind)
+    {
+    case Kind::Shader:
+    {
+        std::array<std::string, 3> sources{};
+        for (size_t i{ 0 }; i < job.files.size(); ++i)
+        {
+            if (job.files[i].empty())
+            {
+                continue;
+            }
+            const auto* entry{ pack_->find(PackKind::Shader, job.files[i]) };
+            if (!entry || entry->data.empty())
+            {
+                return false;
+            }
+            // without the 0 byte at the end
+            sources[i].assign(reinterpret_cast<const char*>(entry->data.data()),
+                              entry->data.size() - 1);
+        }
+        job.sources = std::move(sources);
+        return true;
+    }
+    case Kind::Texture:
+    {
+        const auto* entry{ pack_->find(PackKind::Texture, job.files[0]) };
+        if (!entry || entry->data.size() !=
+                          static_cast<size_t>(entry->width) * entry->height * 4)
+        {
+            return false;
+        }
+        job.packed_pixels = entry->data;
+        job.image_size    = glm::ivec2{ static_cast<i32>(entry->width),
+                                     static_cast<i32>(entry->height) };
+        job.channels      = 4;
+        return true;
+    }
+    case Kind::Font:
+    {
+        const auto* entry{ pack_->find(PackKind::Font, job.files[0]) };
+        const size_t glyphs_size{ sizeof(AssetPack::FontGlyph) *
+                                  TextRender::GLYPH_COUNT };
+        if (!entry || entry->font_size != job.size ||
+            entry->data.size() !=
+                glyphs_size + static_cast<size_t>(entry->width) * entry->height)
+        {
+            return false;
+        }
+        for (u32 c{ 0 }; c < TextRender::GLYPH_COUNT; ++c)
+        {
+            AssetPack::FontGlyph glyph{};
+            std::memcpy(&glyph,
+                        entry->data.data() + c * sizeof(AssetPack::FontGlyph),
+                        sizeof(AssetPack::FontGlyph));
+            job.atlas.characters[c] = AssetPack::to_character(glyph);
+        }
+        job.atlas.width  = static_cast<i32>(entry->width);
+        job.atlas.height = static_cast<i32>(entry->height);
+        job.atlas.pixels.assign(entry->data.begin() + glyphs_size,
+                                entry->data.end());
+        return true;
+    }
+    case Kind::Level:
+    {
+        const auto* entry{ pack_->find(PackKind::Level, job.files[0]) };
+        if (!entry)
+        {
+            return false;
+        }
+        // each row is its tile count followed by the tiles
+        const std::span<const u8> data{ entry->data };
+        std::vector<std::vector<u32>> tiles(entry->height);
+        size_t offset{ 0 };
+        for (std::vector<u32>& row : tiles)
+        {
+            u32 count{};
+            if (offset + sizeof(u32) > data.size())
+            {
+                return false;
+            }
+            std::memcpy(&count, data.data() + offset, sizeof(u32));
+            offset += sizeof(u32);
+            if (count > (data.size() - offset) / sizeof(u32))
+            {
+                return false;
+            }
+            row.resize(count);
+            std::memcpy(row.data(), data.data() + offset, count * sizeof(u32));
+            offset += count * sizeof(u32);
+        }
+        job.tiles = std::move(tiles);
+        return true;
+    }
+    }
+    return false;
+}
+
+bool gcom::AssetLoader::upload()
+{
+    if (workers_.empty())
+    {
+        // serial loading, one asset per call
+        const size_t i{ next_++ };
+        if (i < jobs_.size())
+        {
+            decode(jobs_[i]);
+            uploading_.push_back(i);
+        }
+    }
+    else
+    {
+        std::scoped_lock lock{ mutex_ };
+        std::swap(decoded_, uploading_);
+    }
+
+    for (const size_t i : uploading_)
+    {
+        if (jobs_[i].kind == Kind::Level)
+        {
+            waiting_levels_.push_back(i);
+        }
+        else
+        {
+            upload(jobs_[i]);
+        }
+    }
+    uploading_.clear();
+
+    std::erase_if(compiling_,
+                  [this](size_t i)
+                  {
+                      Job& job{ jobs_[i] };
+                      if (!job.shader.ready())
+                      {
+                          return false;
+                      }
+                      job.shader.finish_compile();
+                      ResourceManager::shaders.set(job.name, job.shader);
+                      ++uploaded_;
+                      return true;
+                  });
+
+    if (textures_left_ == 0)
+    {
+        for (const size_t i : waiting_levels_)
+        {
+            Job& job{ jobs_[i] };
+            job.level->load(job.tiles, job.level_width, job.level_height);
+            ++uploaded_;
+        }
+        waiting_levels_.clear();
+    }
+
+    if (uploaded_ < jobs_.size())
+    {
+        return false;
+    }
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+    if (pixel_buffer_ != 0)
+    {
+        glDeleteBuffers(1, &pixel_buffer_);
+        pixel_buffer_ = 0;
+    }
+    return true;
+}
+
+void gcom::AssetLoader::upload(Job& job)
+{
+    switch (job.kind)
+    {
+    case Kind::Shader:
+    {
+        if (!job.error.empty())
+        {
+            std::cerr << "Failed to open shader: " << job.error << "\n";
+            std::exit(-1);
+        }
+        job.shader.begin_compile(job.sources[0], job.sources[1], job.sources[2]);
+        job.sources = {};
+        // finished by upload() once the driver is done with it
+        compiling_.push_back(static_cast<size_t>(&job - jobs_.data()));
+        return;
+    }
+    case Kind::Texture:
+        upload_texture(job);
+        --textures_left_;
+        break;
+    case Kind::Font:
+        job.text->load(job.atlas);
+        job.atlas = {};
+        break;
+    case Kind::Level:
+        return; // built by upload() once all textures are in
+    }
+    ++uploaded_;
+}
+
+void gcom::AssetLoader::upload_texture(Job& job)
+{
+    Texture2D texture{};
+    if (job.alpha)
+    {
+        texture.set_image_format(GL_RGBA);
+        texture.set_internal_format(GL_RGBA);
+    }
+    // packed images are always RGBA, GL drops the alpha of those that go into an
+    // RGB texture
+    if (job.channels == 4)
+    {
+        texture.set_image_format(GL_RGBA);
+    }
+
+    // Copy the pixels into the pixel buffer and let glTexImage2D() read them
+    // from there. The driver can then move them to the texture later instead
+    // of copying them before the call returns. Re-specifying the buffer for
+    // every texture orphans the last one, so this doesn't wait for that upload.
+    const u8* pixels{ job.packed_pixels.empty() ? job.pixels.get()
+                                                : job.packed_pixels.data() };
+    const auto bytes{ static_cast<GLsizeiptr>(job.image_size.x) *
+                      job.image_size.y * job.channels };
+    void* mapped{ nullptr };
+    if (bytes > 0)
+    {
+        if (pixel_buffer_ == 0)
+        {
+            glGenBuffers(1, &pixel_buffer_);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer_);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+        mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                  0,
+                                  bytes,
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+
+    // stb_image rows are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (mapped)
+    {
+        std::memcpy(mapped, pixels, static_cast<size_t>(bytes));
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        // with a buffer bound, the data pointer is an offset into it
+        texture.generate(job.image_size.x, job.image_size.y, nullptr);
+    }
+    else
+    {
+        // nothing decoded, or the buffer couldn't be mapped
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        texture.generate(
+            job.image_size.x, job.image_size.y, const_cast<u8*>(pixels));
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    ResourceManager::textures.set(job.name, texture);
+    job.pixels.reset();
+    job.packed_pixels = {};
+}
+
+float gcom::AssetLoader::progress() const
+{
+    return jobs_.empty() ? 1.0f
+                         : static_cast<float>(uploaded_) /
+                               static_cast<float>(jobs_.size());
+}
+
+u32 gcom::AssetLoader::default_threads()
+{
+    const u32 cores{ std::thread::hardware_concurrency() };
+    return cores > 1 ? cores - 1 : 1;
+}
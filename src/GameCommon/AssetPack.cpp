@@ -0,0 +1,177 @@
+#include <GameCommon/AssetPack.h>
+#include <GameCommon/Common.h>
+
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+gcom::AssetPack::~AssetPack() { close(); }
+
+bool gcom::AssetPack::open(std::string_view path)
+{
+    close();
+
+    // path views here are string literals or come from std::string, so they are
+    // 0 terminated
+#ifdef _WIN32
+    file_ = CreateFileA(path.data(),
+                        GENERIC_READ,
+                        FILE_SHARE_READ,
+                        nullptr,
+                        OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        file_ = nullptr;
+        return false;
+    }
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(file_, &file_size);
+    size_    = static_cast<size_t>(file_size.QuadPart);
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_)
+    {
+        data_ = static_cast<const u8*>(
+            MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    const int fd{ ::open(path.data(), O_RDONLY) };
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        size_ = static_cast<size_t>(info.st_size);
+        void* mapped{ mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0) };
+        data_ = mapped == MAP_FAILED ? nullptr : static_cast<const u8*>(mapped);
+    }
+    // the mapping stays valid without the descriptor
+    ::close(fd);
+#endif
+    if (!data_)
+    {
+        close();
+        return false;
+    }
+
+    // Check the table of contents once, so find() can trust it
+    PackHeader header{};
+    if (size_ < sizeof(PackHeader))
+    {
+        close();
+        return false;
+    }
+    std::memcpy(&header, data_, sizeof(PackHeader));
+    const u64 toc_end{ sizeof(PackHeader) +
+                       static_cast<u64>(header.entry_count) * sizeof(PackEntry) };
+    if (header.magic != MAGIC || header.version != VERSION ||
+        toc_end + header.names_size > size_)
+    {
+        std::cerr << "Ignoring " << path << ", not a version " << VERSION
+                  << " asset pack\n";
+        close();
+        return false;
+    }
+
+    const auto* names{ reinterpret_cast<const char*>(data_ + toc_end) };
+    entries_.reserve(header.entry_count);
+    for (u32 i{ 0 }; i < header.entry_count; ++i)
+    {
+        PackEntry entry{};
+        std::memcpy(&entry,
+                    data_ + sizeof(PackHeader) + i * sizeof(PackEntry),
+                    sizeof(PackEntry));
+        if (static_cast<u64>(entry.name_offset) + entry.name_size >=
+                header.names_size ||
+            entry.offset > size_ || entry.size > size_ - entry.offset)
+        {
+            std::cerr << "Ignoring " << path << ", its entries are broken\n";
+            close();
+            return false;
+        }
+        entries_.push_back(
+            Entry{ entry.kind,
+                   std::string_view{ names + entry.name_offset, entry.name_size },
+                   entry.width,
+                   entry.height,
+                   entry.font_size,
+                   std::span<const u8>{ data_ + entry.offset, entry.size } });
+    }
+    return true;
+}
+
+const gcom::AssetPack::Entry* gcom::AssetPack::find(Kind kind,
+                                                    std::string_view name) const
+{
+    // a few dozen entries, looked up once each at startup
+    for (const Entry& entry : entries_)
+    {
+        if (entry.kind == kind && entry.name == name)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+gcom::AssetPack::FontGlyph gcom::AssetPack::to_glyph(const Character& character)
+{
+    return FontGlyph{ { character.uv_min.x,
+                        character.uv_min.y,
+                        character.uv_max.x,
+                        character.uv_max.y },
+                      { character.size.x,
+                        character.size.y,
+                        character.bearing.x,
+                        character.bearing.y },
+                      character.advance };
+}
+
+gcom::Character gcom::AssetPack::to_character(const FontGlyph& glyph)
+{
+    return Character{ glm::vec2{ glyph.uv[0], glyph.uv[1] },
+                      glm::vec2{ glyph.uv[2], glyph.uv[3] },
+                      glm::ivec2{ glyph.box[0], glyph.box[1] },
+                      glm::ivec2{ glyph.box[2], glyph.box[3] },
+                      glyph.advance };
+}
+
+void gcom::AssetPack::close()
+{
+    entries_.clear();
+#ifdef _WIN32
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_)
+    {
+        CloseHandle(mapping_);
+    }
+    if (file_)
+    {
+        CloseHandle(file_);
+    }
+    mapping_ = nullptr;
+    file_    = nullptr;
+#else
+    if (data_)
+    {
+        munmap(const_cast<u8*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
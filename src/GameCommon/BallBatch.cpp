@@ -0,0 +1,330 @@
+#include <GameCommon/BallBatch.h>
+#include <GameCommon/Types.h>
+#include <GameCommon/Sweep.h>
+
+gcom::BallBatch::Slot gcom::BallBatch::add(const BallDesc& ball,
+                                           const glm::vec2& bounds)
+{
+    Slot slot{};
+    if (!free_slots_.empty())
+    {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+    else
+    {
+        slot = static_cast<Slot>(pos_x_.size());
+
+        pos_x_.push_back(0.0f);
+        pos_y_.push_back(0.0f);
+        prev_x_.push_back(0.0f);
+        prev_y_.push_back(0.0f);
+        step_x_.push_back(0.0f);
+        step_y_.push_back(0.0f);
+        vel_x_.push_back(0.0f);
+        vel_y_.push_back(0.0f);
+        radius_.push_back(0.0f);
+        max_x_.push_back(0.0f);
+        max_y_.push_back(0.0f);
+        moving_.push_back(0.0f);
+        stuck_.push_back(1);
+        active_.push_back(0);
+        hits_.push_back(0);
+        crossed_.push_back(0);
+        for (u32 paddle{ 0 }; paddle < PADDLES_PER_BALL; ++paddle)
+        {
+            paddle_center_x_[paddle].push_back(0.0f);
+            paddle_center_y_[paddle].push_back(0.0f);
+            paddle_half_w_[paddle].push_back(0.0f);
+            paddle_half_h_[paddle].push_back(0.0f);
+            paddle_enabled_[paddle].push_back(0.0f);
+        }
+    }
+
+    set(slot, ball);
+    max_x_[slot]  = bounds.x - ball.size.x;
+    max_y_[slot]  = bounds.y - ball.size.y;
+    active_[slot] = 0;
+    hits_[slot]   = 0;
+    for (u32 paddle{ 0 }; paddle < PADDLES_PER_BALL; ++paddle)
+    {
+        clear_paddle(slot, paddle);
+    }
+    update_moving(slot);
+
+    return slot;
+}
+
+void gcom::BallBatch::remove(Slot slot)
+{
+    active_[slot] = 0;
+    hits_[slot]   = 0;
+    for (u32 paddle{ 0 }; paddle < PADDLES_PER_BALL; ++paddle)
+    {
+        clear_paddle(slot, paddle);
+    }
+    update_moving(slot);
+    free_slots_.push_back(slot);
+}
+
+BallDesc gcom::BallBatch::get(Slot slot) const
+{
+    return BallDesc{ radius_[slot],
+                     stuck_[slot] != 0,
+                     glm::vec2{ pos_x_[slot], pos_y_[slot] },
+                     glm::vec2{ vel_x_[slot], vel_y_[slot] },
+                     glm::vec2{ radius_[slot] * 2.0f, radius_[slot] * 2.0f } };
+}
+
+void gcom::BallBatch::set(Slot slot, const BallDesc& ball)
+{
+    pos_x_[slot]  = ball.pos.x;
+    pos_y_[slot]  = ball.pos.y;
+    prev_x_[slot] = ball.pos.x;
+    prev_y_[slot] = ball.pos.y;
+    step_x_[slot] = 0.0f;
+    step_y_[slot] = 0.0f;
+    vel_x_[slot]  = ball.velocity.x;
+    vel_y_[slot]  = ball.velocity.y;
+    radius_[slot] = ball.radius;
+    stuck_[slot]  = ball.stuck;
+    update_moving(slot);
+}
+
+void gcom::BallBatch::set_pos(Slot slot, const glm::vec2& pos)
+{
+    pos_x_[slot]  = pos.x;
+    pos_y_[slot]  = pos.y;
+    prev_x_[slot] = pos.x;
+    prev_y_[slot] = pos.y;
+    step_x_[slot] = 0.0f;
+    step_y_[slot] = 0.0f;
+}
+
+void gcom::BallBatch::set_velocity(Slot slot, const glm::vec2& velocity)
+{
+    vel_x_[slot] = velocity.x;
+    vel_y_[slot] = velocity.y;
+}
+
+void gcom::BallBatch::set_stuck(Slot slot, bool stuck)
+{
+    stuck_[slot] = stuck;
+    update_moving(slot);
+}
+
+void gcom::BallBatch::set_active(Slot slot, bool active)
+{
+    active_[slot] = active;
+    update_moving(slot);
+}
+
+void gcom::BallBatch::set_paddle(Slot slot, u32 paddle, const glm::vec2& pos,
+                                 const glm::vec2& size)
+{
+    paddle_half_w_[paddle][slot]   = size.x / 2.0f;
+    paddle_half_h_[paddle][slot]   = size.y / 2.0f;
+    paddle_center_x_[paddle][slot] = pos.x + size.x / 2.0f;
+    paddle_center_y_[paddle][slot] = pos.y + size.y / 2.0f;
+    paddle_enabled_[paddle][slot]  = 1.0f;
+}
+
+void gcom::BallBatch::clear_paddle(Slot slot, u32 paddle)
+{
+    paddle_enabled_[paddle][slot] = 0.0f;
+}
+
+void gcom::BallBatch::update_moving(Slot slot)
+{
+    moving_[slot] = (active_[slot] && !stuck_[slot]) ? 1.0f : 0.0f;
+}
+
+namespace
+{
+// The hot loops live in free functions so the __restrict on the parameters is
+// honoured, which lets the compiler vectorize them without runtime alias checks.
+
+// Same rules as BallObject::move for one axis, written without branches: a ball
+// that leaves the bounds has its velocity reversed and is put back on the edge.
+// Stuck and unused slots have moving == 0 and are left untouched.
+// The position before the move and the move itself, before it is cut short by
+// the bounds, are kept for the swept paddle test.
+void integrate_axis(float* __restrict pos, float* __restrict prev,
+                    float* __restrict step, float* __restrict vel,
+                    const float* __restrict max, const float* __restrict moving,
+                    size_t count, float dt)
+{
+    for (size_t i{ 0 }; i < count; ++i)
+    {
+        const float m{ moving[i] };
+        prev[i] = pos[i];
+        step[i] = vel[i] * dt * m;
+        const float p{ pos[i] + step[i] };
+
+        // Plain selects, std::min/max on floats keep a branch that stops the
+        // vectorizer
+        const float out{ m * static_cast<float>((p <= 0.0f) | (p >= max[i])) };
+        const float clamped{ p < 0.0f ? 0.0f : (p > max[i] ? max[i] : p) };
+
+        vel[i] -= 2.0f * out * vel[i];
+        pos[i] = p + out * (clamped - p);
+    }
+}
+
+// Same test as Game::check_collision(BallObject, GameObject): clamp the circle
+// center onto the box and compare the squared distance to the radius.
+// A ball that doesn't overlap the paddle after the step, but whose box around
+// the whole move does, may have gone straight through it. Those are flagged in
+// `crossed` for the exact, and much rarer, sweep in collide_paddles().
+void collide_paddle(const float* __restrict pos_x, const float* __restrict pos_y,
+                    const float* __restrict prev_x, const float* __restrict prev_y,
+                    const float* __restrict step_x, const float* __restrict step_y,
+                    const float* __restrict radius, const float* __restrict moving,
+                    const float* __restrict center_x,
+                    const float* __restrict center_y,
+                    const float* __restrict half_w, const float* __restrict half_h,
+                    const float* __restrict enabled, u8* __restrict hits,
+                    u8* __restrict crossed, size_t count, u8 bit)
+{
+    for (size_t i{ 0 }; i < count; ++i)
+    {
+        const float ball_center_x{ pos_x[i] + radius[i] };
+        const float ball_center_y{ pos_y[i] + radius[i] };
+
+        const float diff_x{ ball_center_x - center_x[i] };
+        const float diff_y{ ball_center_y - center_y[i] };
+        float clamped_x{ diff_x > -half_w[i] ? diff_x : -half_w[i] };
+        float clamped_y{ diff_y > -half_h[i] ? diff_y : -half_h[i] };
+        clamped_x = clamped_x < half_w[i] ? clamped_x : half_w[i];
+        clamped_y = clamped_y < half_h[i] ? clamped_y : half_h[i];
+
+        const float closest_x{ center_x[i] + clamped_x - ball_center_x };
+        const float closest_y{ center_y[i] + clamped_y - ball_center_y };
+
+        const bool overlaps{ closest_x * closest_x + closest_y * closest_y <=
+                             radius[i] * radius[i] };
+        const bool enabled_moving{ moving[i] * enabled[i] != 0.0f };
+
+        // the box around the move, as distances from the paddle's center. Written
+        // with abs() since a select here keeps the loop from being vectorized
+        const float length_x{ std::abs(step_x[i]) };
+        const float length_y{ std::abs(step_y[i]) };
+        const float min_x{ prev_x[i] - center_x[i] + (step_x[i] - length_x) * 0.5f };
+        const float min_y{ prev_y[i] - center_y[i] + (step_y[i] - length_y) * 0.5f };
+        const float max_x{ min_x + length_x + radius[i] * 2.0f };
+        const float max_y{ min_y + length_y + radius[i] * 2.0f };
+
+        // & rather than && so there is no branch in the loop
+        hits[i] |= static_cast<u8>(bit * static_cast<u8>(overlaps & enabled_moving));
+        crossed[i] |= static_cast<u8>(
+            bit * static_cast<u8>((min_x <= half_w[i]) & (max_x >= -half_w[i]) &
+                                  (min_y <= half_h[i]) & (max_y >= -half_h[i]) &
+                                  !overlaps & enabled_moving));
+    }
+}
+} // namespace
+
+void gcom::BallBatch::integrate(float dt)
+{
+    const size_t count{ pos_x_.size() };
+    integrate_axis(pos_x_.data(),
+                   prev_x_.data(),
+                   step_x_.data(),
+                   vel_x_.data(),
+                   max_x_.data(),
+                   moving_.data(),
+                   count,
+                   dt);
+    integrate_axis(pos_y_.data(),
+                   prev_y_.data(),
+                   step_y_.data(),
+                   vel_y_.data(),
+                   max_y_.data(),
+                   moving_.data(),
+                   count,
+                   dt);
+}
+
+void gcom::BallBatch::collide_paddles()
+{
+    std::fill(hits_.begin(), hits_.end(), u8{ 0 });
+    std::fill(crossed_.begin(), crossed_.end(), u8{ 0 });
+
+    for (u32 paddle{ 0 }; paddle < PADDLES_PER_BALL; ++paddle)
+    {
+        collide_paddle(pos_x_.data(),
+                       pos_y_.data(),
+                       prev_x_.data(),
+                       prev_y_.data(),
+                       step_x_.data(),
+                       step_y_.data(),
+                       radius_.data(),
+                       moving_.data(),
+                       paddle_center_x_[paddle].data(),
+                       paddle_center_y_[paddle].data(),
+                       paddle_half_w_[paddle].data(),
+                       paddle_half_h_[paddle].data(),
+                       paddle_enabled_[paddle].data(),
+                       hits_.data(),
+                       crossed_.data(),
+                       pos_x_.size(),
+                       static_cast<u8>(1u << paddle));
+    }
+
+    for (Slot slot{ 0 }; slot < crossed_.size(); ++slot)
+    {
+        if (crossed_[slot] != 0)
+        {
+            sweep_paddles(slot);
+        }
+    }
+}
+
+// The ball moved more than the paddle is thick in one step. It is put back where
+// it first touched a paddle, so the hit is resolved there and the ball doesn't
+// count as having left the field. The sweep follows the whole move, past where
+// integrate() stopped it at the bounds, since that cut the move short on one
+// axis only.
+void gcom::BallBatch::sweep_paddles(Slot slot)
+{
+    const float radius{ radius_[slot] };
+    const glm::vec2 from{ prev_x_[slot], prev_y_[slot] };
+    const glm::vec2 step{ step_x_[slot], step_y_[slot] };
+
+    std::optional<float> first{};
+    u32 first_paddle{ 0 };
+    for (u32 paddle{ 0 }; paddle < PADDLES_PER_BALL; ++paddle)
+    {
+        if (!(crossed_[slot] & (1u << paddle)))
+        {
+            continue;
+        }
+
+        const glm::vec2 half{ paddle_half_w_[paddle][slot],
+                              paddle_half_h_[paddle][slot] };
+        const glm::vec2 center{ paddle_center_x_[paddle][slot],
+                                paddle_center_y_[paddle][slot] };
+        const std::optional<float> t{ sweep_circle_box(from + radius,
+                                                       from + step + radius,
+                                                       radius,
+                                                       center - half,
+                                                       half * 2.0f) };
+        if (t && (!first || *t < *first))
+        {
+            first        = t;
+            first_paddle = paddle;
+        }
+    }
+
+    if (first)
+    {
+        pos_x_[slot] = from.x + step.x * *first;
+        pos_y_[slot] = from.y + step.y * *first;
+        // the ball is back before any bounce off the bounds integrate() applied
+        vel_x_[slot] = step.x != 0.0f ? std::copysign(vel_x_[slot], step.x)
+                                      : vel_x_[slot];
+        vel_y_[slot] = step.y != 0.0f ? std::copysign(vel_y_[slot], step.y)
+                                      : vel_y_[slot];
+        hits_[slot] |= static_cast<u8>(1u << first_paddle);
+    }
+}
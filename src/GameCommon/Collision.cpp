@@ -0,0 +1,82 @@
+#include <GameCommon/Collision.h>
+#include <GameCommon/Types.h>
+
+#include <cmath>
+
+gcom::Direction gcom::vector_direction(const glm::vec2& target)
+{
+    std::array<glm::vec2, 4> compass{
+        glm::vec2(0.0f, 1.0f),  // up
+        glm::vec2(1.0f, 0.0f),  // right
+        glm::vec2(0.0f, -1.0f), // down
+        glm::vec2(-1.0f, 0.0f)  // left
+    };
+
+    float max{ 0.0f };
+    u32 best_match{ 4294967295 };
+    for (u32 i{ 0 }; i < 4; ++i)
+    {
+        float dot_product{ glm::dot(glm::normalize(target), compass[i]) };
+        if (dot_product > max)
+        {
+            max        = dot_product;
+            best_match = i;
+        }
+    }
+    return static_cast<Direction>(best_match);
+}
+
+bool gcom::check_collision(const glm::vec2& one_pos, const glm::vec2& one_size,
+                           const glm::vec2& two_pos, const glm::vec2& two_size)
+{
+    // collsion x-axis?
+    bool collision_x{ one_pos.x + one_size.x >= two_pos.x &&
+                      two_pos.x + two_size.x >= one_pos.x };
+
+    // collision y-axis?
+    bool collision_y{ one_pos.y + one_size.y >= two_pos.y &&
+                      two_pos.y + two_size.y >= one_pos.y };
+
+    // collision only if on both axes
+    return collision_x && collision_y;
+}
+
+gcom::Collision gcom::check_collision(const glm::vec2& center, float radius,
+                                      const glm::vec2& box_pos,
+                                      const glm::vec2& box_size)
+{
+    // calculate AABB info (center, half-extents)
+    glm::vec2 aabb_half_extents{ box_size.x / 2.0f, box_size.y / 2.0f };
+    glm::vec2 aabb_center{ box_pos.x + aabb_half_extents.x,
+                           box_pos.y + aabb_half_extents.y };
+    // get difference vector between both centers
+    glm::vec2 difference{ center - aabb_center };
+    glm::vec2 clamped{ glm::clamp(
+        difference, -aabb_half_extents, aabb_half_extents) };
+    // add clamped value to AABB_center and we get the value of box closest to circle
+    glm::vec2 closest{ aabb_center + clamped };
+    // retrieve vector between center circle and closest point AABB and check if
+    // length <= radius
+    difference = closest - center;
+    if (glm::length(difference) <= radius)
+        return std::make_tuple(true, vector_direction(difference), difference);
+    else
+        return std::make_tuple(false, Direction::UP, glm::vec2(0.0f, 0.0f));
+}
+
+glm::vec2 gcom::paddle_bounce(float ball_center_x, const glm::vec2& velocity,
+                              const glm::vec2& paddle_pos,
+                              const glm::vec2& paddle_size, float base_speed_x)
+{
+    // check where it hit the board, and change velocity based on where it hit
+    // the board
+    float center_board{ paddle_pos.x + paddle_size.x / 2.0f };
+    float distance{ ball_center_x - center_board };
+    float percentage{ distance / (paddle_size.x / 2.0f) };
+
+    // then move accordingly
+    float strength{ 2.0f };
+    glm::vec2 bounced{ base_speed_x * percentage * strength,
+                       -1.0f * std::abs(velocity.y) }; // avoid sticky paddle issue
+    return glm::normalize(bounced) * glm::length(velocity);
+}
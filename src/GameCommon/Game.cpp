@@ -8,6 +8,8 @@
 #include <GameCommon/Common.h>
 #include <GameCommon/BallObject.h>
 #include <GameCommon/ParticleGenerator.h>
+#include <GameCommon/Sweep.h>
+#include <GameCommon/PowerUpKind.h>
 #include <GameCommon/PostProcessor.h>
 
 std::array<bool, 1024> gcom::Game::keys_{};
@@ -23,6 +25,8 @@ gcom::Game::~Game() { ma_engine_uninit(&engine_); }
 
 bool gcom::Game::init()
 {
+    init_start_ = std::chrono::steady_clock::now();
+
     // glfw: initialize and configure
     // ------------------------------
     glfwInit();
@@ -58,6 +62,10 @@ bool gcom::Game::init()
         return false;
     }
 
+    // compiled programs are kept between runs, shaders only compile after
+    // they or the driver changed
+    ProgramCache::open(PROGRAM_CACHE_DIRECTORY);
+
     glfwSetKeyCallback(window_, key_callback);
     glfwSetFramebufferSizeCallback(window_, framebuffer_size_callback);
 
@@ -67,54 +75,63 @@ bool gcom::Game::init()
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    // Files are read and decoded on worker threads, this thread only uploads
+    text_ = std::make_unique<TextRender>();
+    levels_.resize(4);
+    const u32 level_height{ screen_info_.height / 2 };
+    AssetLoader loader{};
+
     // Load shaders
-    ResourceManager::load_shader(
+    loader.add_shader(
         "res/shaders/sprite.vert", "res/shaders/sprite.frag", "", "sprite");
-    ResourceManager::load_shader(
+    loader.add_shader(
         "res/shaders/particle.vert", "res/shaders/particle.frag", "", "particle");
-    ResourceManager::load_shader("res/shaders/postprocessing.vert",
-                                 "res/shaders/postprocessing.frag",
-                                 "",
-                                 "postprocessing");
-
-    // configure shaders
-    glm::mat4 projection{ glm::ortho(0.0f,
-                                     static_cast<float>(screen_info_.width),
-                                     static_cast<float>(screen_info_.height),
-                                     0.0f,
-                                     -1.0f,
-                                     1.0f) };
-
-    ResourceManager::get_shader("sprite").use().set_integer("image", 0);
-    ResourceManager::get_shader("sprite").set_matrix4("projection", projection);
-
-    ResourceManager::get_shader("particle").use().set_integer("sprite", 0);
-    ResourceManager::get_shader("particle").set_matrix4("projection", projection);
+    loader.add_shader("res/shaders/postprocessing.vert",
+                      "res/shaders/postprocessing.frag",
+                      "",
+                      "postprocessing");
 
     // Load textures
-    ResourceManager::load_texture("res/textures/awesomeface.png", true, "face");
-    ResourceManager::load_texture(
-        "res/textures/background.jpg", false, "background");
-    ResourceManager::load_texture("res/textures/block.png", false, "block");
-    ResourceManager::load_texture(
+    loader.add_texture("res/textures/awesomeface.png", true, "face");
+    loader.add_texture("res/textures/background.jpg", false, "background");
+    loader.add_texture("res/textures/block.png", false, "block");
+    loader.add_texture(
         "res/textures/indestructible_block.png", false, "indestructible_block");
-    ResourceManager::load_texture("res/textures/paddle.png", true, "paddle");
+    loader.add_texture("res/textures/paddle.png", true, "paddle");
 
-    ResourceManager::load_texture("res/textures/particle.png", true, "particle");
+    loader.add_texture("res/textures/particle.png", true, "particle");
 
-    ResourceManager::load_texture(
-        "res/textures/powerup_speed.png", true, "powerup_speed");
-    ResourceManager::load_texture(
-        "res/textures/powerup_sticky.png", true, "powerup_sticky");
-    ResourceManager::load_texture(
+    loader.add_texture("res/textures/powerup_speed.png", true, "powerup_speed");
+    loader.add_texture("res/textures/powerup_sticky.png", true, "powerup_sticky");
+    loader.add_texture(
         "res/textures/powerup_increase.png", true, "powerup_increase");
-    ResourceManager::load_texture(
-        "res/textures/powerup_confuse.png", true, "powerup_confuse");
-    ResourceManager::load_texture(
-        "res/textures/powerup_chaos.png", true, "powerup_chaos");
-    ResourceManager::load_texture(
+    loader.add_texture("res/textures/powerup_confuse.png", true, "powerup_confuse");
+    loader.add_texture("res/textures/powerup_chaos.png", true, "powerup_chaos");
+    loader.add_texture(
         "res/textures/powerup_passthrough.png", true, "powerup_passthrough");
 
+    loader.add_font("res/fonts/OCRAEXT.TTF", font_size_, *text_);
+
+    // Load levels
+    loader.add_level(
+        "res/levels/one.lvl", screen_info_.width, level_height, levels_[0]);
+    loader.add_level(
+        "res/levels/two.lvl", screen_info_.width, level_height, levels_[1]);
+    loader.add_level(
+        "res/levels/three.lvl", screen_info_.width, level_height, levels_[2]);
+    loader.add_level(
+        "res/levels/four.lvl", screen_info_.width, level_height, levels_[3]);
+
+    if (!load_assets(loader))
+    {
+        return false;
+    }
+
+    // configure shaders
+    init_view_uniforms();
+    ResourceManager::get_shader("sprite").use().set_integer("image", 0);
+    ResourceManager::get_shader("particle").use().set_integer("sprite", 0);
+
     // Set render-specific controls
     sprite_renderer_ = std::make_unique<gcom::SpriteRenderer>(
         gcom::ResourceManager::get_shader("sprite"));
@@ -127,21 +144,6 @@ bool gcom::Game::init()
         screen_info_.width,
         screen_info_.height);
 
-    // Load levels
-    GameLevel one;
-    one.load("res/levels/one.lvl", screen_info_.width, screen_info_.height / 2);
-    GameLevel two;
-    two.load("res/levels/two.lvl", screen_info_.width, screen_info_.height / 2);
-    GameLevel three;
-    three.load("res/levels/three.lvl", screen_info_.width, screen_info_.height / 2);
-    GameLevel four;
-    four.load("res/levels/four.lvl", screen_info_.width, screen_info_.height / 2);
-
-    levels_.push_back(one);
-    levels_.push_back(two);
-    levels_.push_back(three);
-    levels_.push_back(four);
-
     // configure game objects
     // Player 1
     glm::vec2 player1_pos{ glm::vec2{ screen_info_.width / 2.0f -
@@ -173,9 +175,6 @@ bool gcom::Game::init()
                                         ResourceManager::get_texture("paddle"),
                                         screen_info_);
 
-    text_ = std::make_unique<TextRender>(screen_info_.width, screen_info_.height);
-    text_->load("res/fonts/OCRAEXT.TTF", font_size_);
-
     // Main Menu theme
     result_ = ma_engine_init(nullptr, &engine_);
     if (result_ != MA_SUCCESS)
@@ -183,6 +182,7 @@ bool gcom::Game::init()
         std::cerr << "Failed to initialize audio\n";
         return false;
     }
+    register_packed_audio();
     ma_engine_play_sound(&engine_, "res/audio/breakout.mp3", nullptr);
 
     return true;
@@ -369,7 +369,10 @@ void gcom::Game::process_player2_input(float dt)
 bool gcom::Game::update(float dt)
 {
     // update objects
+    const glm::vec2 ball_from{ ball_->pos_ };
+    const glm::vec2 ball_velocity{ ball_->velocity_ };
     ball_->move(dt, screen_info_.width, screen_info_.height);
+    sweep_ball(ball_from, ball_velocity, dt);
 
     // Check for collisions
     do_collisions();
@@ -426,26 +429,8 @@ bool gcom::Game::update(float dt)
 
 void gcom::Game::reset_level()
 {
-    if (current_level_ == 0)
-    {
-        levels_[0].load(
-            "res/levels/one.lvl", screen_info_.width, screen_info_.height / 2);
-    }
-    else if (current_level_ == 1)
-    {
-        levels_[1].load(
-            "res/levels/two.lvl", screen_info_.width, screen_info_.height / 2);
-    }
-    else if (current_level_ == 2)
-    {
-        levels_[2].load(
-            "res/levels/three.lvl", screen_info_.width, screen_info_.height / 2);
-    }
-    else if (current_level_ == 3)
-    {
-        levels_[3].load(
-            "res/levels/four.lvl", screen_info_.width, screen_info_.height / 2);
-    }
+    // the layout was kept when the level was loaded, only the bricks come back
+    levels_[current_level_].reset();
 
     player1_->lives_ = 3;
     player2_->lives_ = 3;
@@ -486,7 +471,7 @@ void gcom::Game::render()
         effects_->begin_render();
         // Draw background
         sprite_renderer_->draw_sprite(
-            gcom::ResourceManager::get_texture("background"),
+            ResourceManager::get_texture(background_texture_),
             glm::vec2(0.0f, 0.0f),
             glm::vec2(screen_info_.width, screen_info_.height),
             0.0f);
@@ -513,55 +498,59 @@ void gcom::Game::render()
         effects_->render(glfwGetTime());
 
         // Show lives
-        std::stringstream ss;
-        ss << player2_->lives_;
-        text_->render_text("Lives " + ss.str(), 5.0f, 5.0f, 1.0f);
-        ss.str("");
-        ss.clear();
-        ss << player1_->lives_;
-        text_->render_text(
-            "Lives " + ss.str(), 5.0f, screen_info_.height - font_size_, 1.0f);
+        text_->draw_run(lives_text(player2_->lives_), 5.0f, 5.0f, 1.0f);
+        text_->draw_run(lives_text(player1_->lives_),
+                        5.0f,
+                        screen_info_.height - font_size_,
+                        1.0f);
     }
 
     if (state_ == GameState::GAME_READY)
     {
-        text_->render_text(
+        text_->draw_run(
             "Press ENTER to start", 250.0f, screen_info_.height / 2, 1.0f);
-        text_->render_text("Press W or S to select level",
-                           245.0f,
-                           screen_info_.height / 2 + 20.0f,
-                           0.75f);
+        text_->draw_run("Press W or S to select level",
+                        245.0f,
+                        screen_info_.height / 2 + 20.0f,
+                        0.75f);
     }
 
     if (state_ == GameState::GAME_ENDS)
     {
-        std::string winner{};
+        std::string_view winner{};
         if (winner_ == Winner::Player1)
         {
-            winner = "PLAYER 1";
+            winner = "PLAYER 1 WON!";
         }
         else if (winner_ == Winner::Player2)
         {
-            winner = "PLAYER 2";
+            winner = "PLAYER 2 WON!";
+        }
+        else
+        {
+            winner = " WON!";
         }
 
-        text_->render_text(winner + " WON!",
-                           320.0,
-                           screen_info_.height / 2 - 20.0,
-                           1.0,
-                           glm::vec3(0.0, 1.0, 0.0));
-        text_->render_text("Press ENTER to retry or ESC to quit",
-                           130.0,
-                           screen_info_.height / 2,
-                           1.0,
-                           glm::vec3(1.0, 1.0, 0.0));
+        text_->draw_run(winner,
+                        320.0,
+                        screen_info_.height / 2 - 20.0,
+                        1.0,
+                        glm::vec3(0.0, 1.0, 0.0));
+        text_->draw_run("Press ENTER to retry or ESC to quit",
+                        130.0,
+                        screen_info_.height / 2,
+                        1.0,
+                        glm::vec3(1.0, 1.0, 0.0));
     }
 }
 
 void gcom::Game::do_collisions()
 {
-    for (GameObject& box : levels_[current_level_].bricks)
+    GameLevel& level{ levels_[current_level_] };
+    const auto [near_min, near_max]{ collision_bounds(*ball_) };
+    for (const u32 brick : level.bricks_near(near_min, near_max))
     {
+        GameObject& box{ level.bricks[brick] };
         if (!box.destroyed_)
         {
             Collision collision{ check_collision(*ball_, box) };
@@ -648,24 +637,15 @@ void gcom::Game::do_collisions()
     }
 
     // and finally check collisions for player1_ pad (unless stuck)
+    const float ball_center_x{ ball_->pos_.x + ball_->radius_ };
     Collision result{ check_collision(*ball_, *player1_) };
     if (!ball_->stuck_ && std::get<0>(result))
     {
-        // check where it hit the board, and change velocity based on where it hit
-        // the board
-        float center_board{ player1_->pos_.x + player1_->size_.x / 2.0f };
-        float distance{ ball_->pos_.x + ball_->radius_ - center_board };
-        float percentage{ distance / (player1_->size_.x / 2.0f) };
-
-        // then move accordingly
-        float strength{ 2.0f };
-        glm::vec2 old_velocity{ ball_->velocity_ };
-        ball_->velocity_.x = initial_ball_velocity_.x * percentage * strength;
-        // ball_->velocity_.y = -ball_->velocity_.y;
-        ball_->velocity_.y =
-            -1.0f * abs(ball_->velocity_.y); // avoid sticky paddle issue
-        ball_->velocity_ =
-            glm::normalize(ball_->velocity_) * glm::length(old_velocity);
+        ball_->velocity_ = paddle_bounce(ball_center_x,
+                                         ball_->velocity_,
+                                         player1_->pos_,
+                                         player1_->size_,
+                                         initial_ball_velocity_.x);
 
         ball_->stuck_ = ball_->sticky_;
 
@@ -676,23 +656,12 @@ void gcom::Game::do_collisions()
     result = check_collision(*ball_, *player2_);
     if (!ball_->stuck_ && std::get<0>(result))
     {
-        // check where it hit the board, and change velocity based on where it hit
-        // the board
-        float center_board{ player2_->pos_.x + player2_->size_.x / 2.0f };
-        float distance{ ball_->pos_.x + ball_->radius_ - center_board };
-        float percentage{ distance / (player2_->size_.x / 2.0f) };
-
-        // then move accordingly
-        float strength{ 2.0f };
-        glm::vec2 old_velocity{ ball_->velocity_ };
-        ball_->velocity_.x = initial_ball_velocity_.x * percentage * strength;
-        // ball_->velocity_.y = -ball_->velocity_.y;
-        ball_->velocity_.y =
-            -1.0f * abs(ball_->velocity_.y); // avoid sticky paddle issue
-        ball_->velocity_ =
-            glm::normalize(-ball_->velocity_) *
-            glm::length(old_velocity); // Flip the velocity_ of the player2 pad to
-                                       // shoot the ball downward
+        // Flip the velocity_ of the player2 pad to shoot the ball downward
+        ball_->velocity_ = -paddle_bounce(ball_center_x,
+                                          ball_->velocity_,
+                                          player2_->pos_,
+                                          player2_->size_,
+                                          initial_ball_velocity_.x);
 
         ball_->stuck_ = ball_->sticky_;
 
@@ -700,67 +669,20 @@ void gcom::Game::do_collisions()
     }
 }
 
-bool should_spawn(u32 chance)
-{
-    u32 random{ std::rand() % chance };
-    return random == 0;
-}
-
 void gcom::Game::spawn_powerups(GameObject& block)
 {
-    if (should_spawn(75)) // 1 in 75 chance
-    {
-        powerups_.emplace_back(
-            PowerUp{ "speed",
-                     glm::vec3{ 0.5f, 0.5f, 1.0f },
-                     0.0f, // here a duration of 0.0f means its duration is infinite
-                     block.pos_,
-                     ResourceManager::get_texture("powerup_speed") });
-    }
-    if (should_spawn(75))
-    {
-        powerups_.emplace_back(
-            PowerUp{ "sticky",
-                     glm::vec3{ 1.0f, 0.5f, 1.0f },
-                     20.0f,
-                     block.pos_,
-                     ResourceManager::get_texture("powerup_sticky") });
-    }
-    if (should_spawn(75))
-    {
-        powerups_.emplace_back(
-            PowerUp{ "passthrough",
-                     glm::vec3{ 0.5f, 1.0f, 0.5f },
-                     10.0f,
-                     block.pos_,
-                     ResourceManager::get_texture("powerup_passthrough") });
-    }
-    if (should_spawn(75))
-    {
-        powerups_.emplace_back(
-            PowerUp{ "pad-size-increase",
-                     glm::vec3{ 1.0f, 0.6f, 0.4 },
-                     0.0f,
-                     block.pos_,
-                     ResourceManager::get_texture("powerup_increase") });
-    }
-    if (should_spawn(15)) // Negative powerups should spawn more often
-    {
-        powerups_.emplace_back(
-            PowerUp{ "confuse",
-                     glm::vec3{ 1.0f, 0.3f, 0.3f },
-                     15.0f,
-                     block.pos_,
-                     ResourceManager::get_texture("powerup_confuse") });
-    }
-    if (should_spawn(15))
-    {
-        powerups_.emplace_back(
-            PowerUp{ "chaos",
-                     glm::vec3{ 0.9f, 0.25f, 0.25f },
-                     15.0f,
-                     block.pos_,
-                     ResourceManager::get_texture("powerup_chaos") });
+    for (size_t i{ 0 }; i < POWERUP_KINDS.size(); ++i)
+    {
+        const PowerUpKind& kind{ POWERUP_KINDS[i] };
+        if (should_spawn(kind))
+        {
+            powerups_.emplace_back(
+                PowerUp{ kind.type,
+                         kind.color,
+                         kind.duration,
+                         block.pos_,
+                         ResourceManager::get_texture(powerup_textures_[i]) });
+        }
     }
 }
 
@@ -878,65 +800,87 @@ void gcom::Game::update_powerups(float dt)
 
 bool gcom::Game::check_collision(const GameObject& one, const GameObject& two)
 {
-    // collsion x-axis?
-    bool collision_x{ one.pos_.x + one.size_.x >= two.pos_.x &&
-                      two.pos_.x + two.size_.x >= one.pos_.x };
-
-    // collision y-axis?
-    bool collision_y{ one.pos_.y + one.size_.y >= two.pos_.y &&
-                      two.pos_.y + two.size_.y >= one.pos_.y };
-
-    // collision only if on both axes
-    return collision_x && collision_y;
+    return gcom::check_collision(one.pos_, one.size_, two.pos_, two.size_);
 }
 
 gcom::Collision gcom::Game::check_collision(const BallObject& one, const GameObject& two)
 {
-    // get center point circle first
-    glm::vec2 center{ one.pos_ + one.radius_ };
-    // calculate AABB info (center, half-extents)
-    glm::vec2 aabb_half_extents{ two.size_.x / 2.0f, two.size_.y / 2.0f };
-    glm::vec2 aabb_center{ two.pos_.x + aabb_half_extents.x,
-                           two.pos_.y + aabb_half_extents.y };
-    // get difference vector between both centers
-    glm::vec2 difference{ center - aabb_center };
-    glm::vec2 clamped{ glm::clamp(
-        difference, -aabb_half_extents, aabb_half_extents) };
-    // add clamped value to AABB_center and we get the value of box closest to circle
-    glm::vec2 closest{ aabb_center + clamped };
-    // retrieve vector between center circle and closest point AABB and check if
-    // length <= radius
-    difference = closest - center;
-    if (glm::length(difference) <= one.radius_)
-        return std::make_tuple(true, vector_direction(difference), difference);
-    else
-        return std::make_tuple(false, gcom::Direction::UP, glm::vec2(0.0f, 0.0f));
+    return gcom::check_collision(
+        one.pos_ + one.radius_, one.radius_, two.pos_, two.size_);
 }
 
-gcom::Direction gcom::Game::vector_direction(const glm::vec2& target)
+// Follows the whole move, also past where BallObject::move() stopped the ball at
+// the window edge, since that cut the move short on one axis only
+void gcom::Game::sweep_ball(const glm::vec2& from, const glm::vec2& velocity,
+                            float dt)
 {
-    std::array<glm::vec2, 4> compass{
-        glm::vec2(0.0f, 1.0f),  // up
-        glm::vec2(1.0f, 0.0f),  // right
-        glm::vec2(0.0f, -1.0f), // down
-        glm::vec2(-1.0f, 0.0f)  // left
-    };
+    const glm::vec2 step{ velocity * dt };
+    if (ball_->stuck_ || (step.x == 0.0f && step.y == 0.0f))
+    {
+        return;
+    }
 
-    float max{ 0.0f };
-    u32 best_match{ 4294967295 };
-    for (u32 i{ 0 }; i < 4; ++i)
+    // sweep_circle_box() works with the center of the ball
+    const float radius{ ball_->radius_ };
+    const glm::vec2 center{ radius };
+    std::optional<float> first{};
+    const GameObject* first_box{ nullptr };
+    const auto sweep = [&](const GameObject& box)
     {
-        float dot_product{ glm::dot(glm::normalize(target), compass[i]) };
-        if (dot_product > max)
+        const std::optional<float> t{ sweep_circle_box(
+            from + center, from + step + center, radius, box.pos_, box.size_) };
+        if (t && (!first || *t < *first))
+        {
+            first     = t;
+            first_box = &box;
+        }
+    };
+
+    GameLevel& level{ levels_[current_level_] };
+    const glm::vec2 to{ from + step };
+    const glm::vec2 min{ std::min(from.x, to.x) - radius,
+                         std::min(from.y, to.y) - radius };
+    const glm::vec2 max{ std::max(from.x, to.x) + 3.0f * radius,
+                         std::max(from.y, to.y) + 3.0f * radius };
+    for (const u32 brick : level.bricks_near(min, max))
+    {
+        const GameObject& box{ level.bricks[brick] };
+        // pass-through balls go through non-solid bricks anyway
+        if (!box.destroyed_ && !(ball_->passthrough_ && !box.is_solid_))
         {
-            max        = dot_product;
-            best_match = i;
+            sweep(box);
         }
     }
-    return static_cast<Direction>(best_match);
+    sweep(*player1_);
+    sweep(*player2_);
+
+    // nothing in the way, or the ball still touches it and do_collisions() sees it
+    if (!first || std::get<0>(check_collision(*ball_, *first_box)))
+    {
+        return;
+    }
+
+    // back to before any bounce off the window edge
+    const float depth{ CONTACT_DEPTH / glm::length(step) };
+    ball_->pos_      = from + step * std::min(*first + depth, 1.0f);
+    ball_->velocity_ = velocity;
 }
 
-void gcom::Game::shutdown() { sprite_renderer_.reset(); }
+std::pair<glm::vec2, glm::vec2> gcom::Game::collision_bounds(
+    const BallObject& ball) const
+{
+    const glm::vec2 radius{ ball.radius_ };
+    return { ball.pos_ - radius, ball.pos_ + 3.0f * radius };
+}
+
+void gcom::Game::shutdown()
+{
+    sprite_renderer_.reset();
+    sprite_batch_.reset();
+    particles_.reset();
+    text_.reset();
+    view_uniforms_.reset();
+}
 
 // process all input: query GLFW whether relevant keys are pressed/released this
 // frame and react accordingly
@@ -968,4 +912,96 @@ void gcom::Game::framebuffer_size_callback(GLFWwindow* window, int width, int he
     // make sure the viewport matches the new window dimensions; note that width and
     // height will be significantly larger than specified on retina displays.
     glViewport(0, 0, width, height);
+}
+
+std::string_view gcom::Game::lives_text(u32 lives)
+{
+    constexpr std::string_view prefix{ "Lives " };
+    char* const begin{ lives_text_.data() };
+    std::copy(prefix.begin(), prefix.end(), begin);
+    const auto result{ std::to_chars(
+        begin + prefix.size(), begin + lives_text_.size(), lives) };
+    return std::string_view{ begin, static_cast<size_t>(result.ptr - begin) };
+}
+
+void gcom::Game::init_view_uniforms()
+{
+    // the game is laid out in screen_info_ units whatever the window size is
+    ViewUniforms view{};
+    view.projection = glm::ortho(0.0f,
+                                 static_cast<float>(screen_info_.width),
+                                 static_cast<float>(screen_info_.height),
+                                 0.0f,
+                                 -1.0f,
+                                 1.0f);
+
+    view_uniforms_ =
+        std::make_unique<UniformBuffer>(UniformBlock::View, sizeof(ViewUniforms));
+    view_uniforms_->update(view);
+}
+
+bool gcom::Game::load_assets(AssetLoader& loader)
+{
+    const auto load_start{ std::chrono::steady_clock::now() };
+    // baked by AssetBake, without one the loose files are loaded
+    if (pack_.open(PACK_FILE))
+    {
+        loader.use_pack(pack_);
+    }
+    loader.start();
+    while (!loader.upload())
+    {
+        if (glfwWindowShouldClose(window_))
+        {
+            return false;
+        }
+
+        // a bar across the middle of the window, filling up from the left
+        const auto bar_width{ static_cast<i32>(screen_info_.width * 3 / 4) };
+        const i32 bar_height{ 8 };
+        const i32 x{ (static_cast<i32>(screen_info_.width) - bar_width) / 2 };
+        const i32 y{ (static_cast<i32>(screen_info_.height) - bar_height) / 2 };
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(x, y, bar_width, bar_height);
+        glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        const auto filled{ static_cast<i32>(bar_width * loader.progress()) };
+        glScissor(x, y, filled, bar_height);
+        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDisable(GL_SCISSOR_TEST);
+
+        glfwSwapBuffers(window_);
+        glfwPollEvents();
+    }
+
+    const auto now{ std::chrono::steady_clock::now() };
+    const std::chrono::duration<double, std::milli> loading{ now - load_start };
+    const std::chrono::duration<double, std::milli> startup{ now - init_start_ };
+    std::cout << "Assets loaded in " << loading.count() << " ms, startup took "
+              << startup.count() << " ms\n";
+
+    background_texture_ = ResourceManager::texture_handle("background");
+    paddle_texture_     = ResourceManager::texture_handle("paddle");
+    for (size_t i{ 0 }; i < POWERUP_KINDS.size(); ++i)
+    {
+        powerup_textures_[i] =
+            ResourceManager::texture_handle(POWERUP_KINDS[i].texture);
+    }
+    return true;
+}
+
+void gcom::Game::register_packed_audio()
+{
+    ma_resource_manager* resources{ ma_engine_get_resource_manager(&engine_) };
+    for (const AssetPack::Entry& entry : pack_.entries())
+    {
+        if (entry.kind == AssetPack::Kind::Audio)
+        {
+            ma_resource_manager_register_encoded_data(
+                resources, entry.name.data(), entry.data.data(), entry.data.size());
+        }
+    }
 }
\ No newline at end of file
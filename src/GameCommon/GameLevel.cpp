@@ -4,35 +4,48 @@
 
 void gcom::GameLevel::load(std::string_view file, u32 level_width, u32 level_height)
 {
-    // Clear old data
-    bricks.clear();
+    load(LevelTemplate::read_tiles(file), level_width, level_height);
+}
+
+void gcom::GameLevel::load(const std::vector<std::vector<u32>>& tile_data,
+                           u32 level_width, u32 level_height)
+{
+    template_ = LevelTemplate{ tile_data, level_width, level_height };
 
-    // Load from file
-    u32 tile_code{};
-    std::string line{};
-    std::ifstream fstream{ file.data() };
-    std::vector<std::vector<u32>> tile_data{};
+    // looked up once, not once per tile
+    const Texture2D indestructible_block{ ResourceManager::get_texture(
+        "indestructible_block") };
+    const Texture2D block{ ResourceManager::get_texture("block") };
 
-    if (fstream)
+    bricks.clear();
+    bricks.reserve(template_.bricks().size());
+    for (const LevelTemplate::Brick& brick : template_.bricks())
     {
-        while (std::getline(fstream, line)) // read each line from level file
-        {
-            std::istringstream sstream{ line };
-            std::vector<u32> row;
-            while (sstream >> tile_code) // read each word separated by spaces
-            {
-                row.push_back(tile_code);
-            }
-            tile_data.push_back(row);
-        }
+        GameObject obj{ brick.pos,
+                        brick.size,
+                        brick.solid ? indestructible_block : block,
+                        brick.color };
+        obj.is_solid_ = brick.solid;
+        bricks.push_back(obj);
+    }
+}
 
-        if (tile_data.size() > 0)
-        {
-            init(tile_data, level_width, level_height);
-        }
+void gcom::GameLevel::reset()
+{
+    // being destroyed is all a match changes about a brick
+    for (GameObject& brick : bricks)
+    {
+        brick.destroyed_ = false;
     }
 }
 
+std::span<const u32> gcom::GameLevel::bricks_near(const glm::vec2& min,
+                                                  const glm::vec2& max)
+{
+    template_.grid().query(min, max, nearby_);
+    return nearby_;
+}
+
 void gcom::GameLevel::draw(SpriteRenderer& renderer)
 {
     for (GameObject& brick : bricks)
@@ -44,70 +57,25 @@ void gcom::GameLevel::draw(SpriteRenderer& renderer)
     }
 }
 
-bool gcom::GameLevel::is_completed()
+void gcom::GameLevel::draw(SpriteBatch& batch, u32 layer)
 {
     for (GameObject& brick : bricks)
     {
-        if (!brick.is_solid_ && !brick.destroyed_)
+        if (!brick.destroyed_)
         {
-            return false;
+            brick.draw(batch, layer);
         }
     }
-    return true;
 }
 
-void gcom::GameLevel::init(const std::vector<std::vector<u32>>& tile_data,
-                         u32 level_width, u32 level_height)
+bool gcom::GameLevel::is_completed()
 {
-    // Calculate dimensions
-    std::size_t width{ tile_data[0].size() };
-    std::size_t height{ tile_data.size() };
-    float unit_width{ level_width / static_cast<float>(width) };
-    float unit_height{ level_height / static_cast<float>(height) };
-
-    // Init level tiles based on tile_data
-    for (u32 y{ 0 }; y < height; ++y)
+    for (GameObject& brick : bricks)
     {
-        for (u32 x{ 0 }; x < width; ++x)
+        if (!brick.is_solid_ && !brick.destroyed_)
         {
-            // Check block type from level data (2D level array)
-            if (tile_data[y][x] == 1) // indestructible
-            {
-                glm::vec2 pos{ unit_width * x, unit_height * y };
-                glm::vec2 size{ unit_width, unit_height };
-                GameObject obj{ pos,
-                                size,
-                                ResourceManager::get_texture("indestructible_block"),
-                                glm::vec3{ 0.8, 0.8f, 0.7f } };
-
-                obj.is_solid_ = true;
-                bricks.push_back(obj);
-            }
-            else if (tile_data[y][x] > 1) // destructible
-            {
-                glm::vec3 color{ glm::vec3{ 1.0f } };
-                if (tile_data[y][x] == 2)
-                {
-                    color = glm::vec3{ 0.2f, 0.6f, 1.0f };
-                }
-                else if (tile_data[y][x] == 3)
-                {
-                    color = glm::vec3{ 0.0f, 0.7f, 0.0f };
-                }
-                else if (tile_data[y][y] == 4)
-                {
-                    color = glm::vec3{ 0.8f, 0.8f, 0.4f };
-                }
-                else if (tile_data[y][x] == 5)
-                {
-                    color = glm::vec3{ 1.0f, 0.5f, 0.0f };
-                }
-
-                glm::vec2 pos{ unit_width * x, unit_height * y };
-                glm::vec2 size{ unit_width, unit_height };
-                bricks.push_back(GameObject{
-                    pos, size, ResourceManager::get_texture("block"), color });
-            }
+            return false;
         }
     }
+    return true;
 }
@@ -19,3 +19,8 @@ void gcom::GameObject::draw(SpriteRenderer& renderer)
     renderer.draw_sprite(sprite_, pos_, size_, rotation_, color_);
 }
 
+void gcom::GameObject::draw(SpriteBatch& batch, u32 layer)
+{
+    batch.add(sprite_, pos_, size_, rotation_, color_, layer);
+}
+
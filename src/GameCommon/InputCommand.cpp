@@ -0,0 +1,82 @@
+#include <GameCommon/InputCommand.h>
+#include <GameCommon/Types.h>
+
+float gcom::apply_input(float pos_x, i8 direction, float duration, float max_x)
+{
+    return std::clamp(pos_x + direction * PADDLE_SPEED * duration, 0.0f, max_x);
+}
+
+namespace
+{
+// Wire format:
+//   u32 sequence of the first command
+//   u16 tick of the last command
+//   u8  count
+//   for every command, in sequence order:
+//     i8 direction, u8 duration_ms, u8 how many ticks older than the last one
+//     its tick is
+constexpr size_t HEADER_BYTES{ sizeof(u32) + sizeof(u16) + sizeof(u8) };
+constexpr size_t COMMAND_BYTES{ sizeof(i8) + sizeof(u8) + sizeof(u8) };
+} // namespace
+
+void gcom::encode_inputs(std::span<const InputCommand> commands,
+                         std::vector<u8>& out)
+{
+    if (commands.empty())
+    {
+        return;
+    }
+
+    const u32 first{ commands.front().sequence };
+    const u16 tick{ commands.back().tick };
+    const u8 count{ static_cast<u8>(std::min<size_t>(commands.size(), 255)) };
+
+    for (u32 byte{ 0 }; byte < sizeof(u32); ++byte)
+    {
+        out.push_back(static_cast<u8>(first >> (byte * 8)));
+    }
+    out.push_back(static_cast<u8>(tick & 0xff));
+    out.push_back(static_cast<u8>(tick >> 8));
+    out.push_back(count);
+
+    for (u32 i{ 0 }; i < count; ++i)
+    {
+        out.push_back(static_cast<u8>(commands[i].direction));
+        out.push_back(commands[i].duration_ms);
+        out.push_back(static_cast<u8>(
+            std::min<u16>(static_cast<u16>(tick - commands[i].tick), 255)));
+    }
+}
+
+bool gcom::decode_inputs(std::span<const u8> in, std::vector<InputCommand>& out)
+{
+    out.clear();
+    if (in.size() < HEADER_BYTES)
+    {
+        return false;
+    }
+
+    u32 first{ 0 };
+    for (u32 byte{ 0 }; byte < sizeof(u32); ++byte)
+    {
+        first |= static_cast<u32>(in[byte]) << (byte * 8);
+    }
+    const u16 tick{ static_cast<u16>(in[4] | (in[5] << 8)) };
+    const u8 count{ in[6] };
+
+    if (in.size() != HEADER_BYTES + count * COMMAND_BYTES)
+    {
+        return false;
+    }
+
+    out.resize(count);
+    for (u32 i{ 0 }; i < count; ++i)
+    {
+        const size_t offset{ HEADER_BYTES + i * COMMAND_BYTES };
+        out[i].sequence    = first + i;
+        out[i].tick        = static_cast<u16>(tick - in[offset + 2]);
+        out[i].direction   = std::clamp<i8>(static_cast<i8>(in[offset]), -1, 1);
+        out[i].duration_ms = in[offset + 1];
+    }
+    return true;
+}
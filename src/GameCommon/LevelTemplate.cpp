@@ -0,0 +1,80 @@
+#include <GameCommon/LevelTemplate.h>
+
+gcom::LevelTemplate::LevelTemplate(const std::vector<std::vector<u32>>& tile_data,
+                                   u32 level_width, u32 level_height)
+{
+    if (tile_data.empty())
+    {
+        return;
+    }
+
+    // Calculate dimensions
+    std::size_t width{ tile_data[0].size() };
+    std::size_t height{ tile_data.size() };
+    float unit_width{ level_width / static_cast<float>(width) };
+    float unit_height{ level_height / static_cast<float>(height) };
+    grid_ = TileGrid{ static_cast<u32>(width),
+                      static_cast<u32>(height),
+                      glm::vec2{ unit_width, unit_height } };
+
+    // Init level tiles based on tile_data
+    for (u32 y{ 0 }; y < height; ++y)
+    {
+        for (u32 x{ 0 }; x < width; ++x)
+        {
+            const u32 tile{ tile_data[y][x] };
+            if (tile == 0)
+            {
+                continue;
+            }
+
+            glm::vec3 color{ 1.0f };
+            if (tile == 1) // indestructible
+            {
+                color = glm::vec3{ 0.8f, 0.8f, 0.7f };
+            }
+            else if (tile == 2)
+            {
+                color = glm::vec3{ 0.2f, 0.6f, 1.0f };
+            }
+            else if (tile == 3)
+            {
+                color = glm::vec3{ 0.0f, 0.7f, 0.0f };
+            }
+            else if (tile == 4)
+            {
+                color = glm::vec3{ 0.8f, 0.8f, 0.4f };
+            }
+            else if (tile == 5)
+            {
+                color = glm::vec3{ 1.0f, 0.5f, 0.0f };
+            }
+
+            grid_.set(x, y, static_cast<u32>(bricks_.size()));
+            bricks_.push_back(Brick{ glm::vec2{ unit_width * x, unit_height * y },
+                                     glm::vec2{ unit_width, unit_height },
+                                     color,
+                                     tile == 1 });
+        }
+    }
+}
+
+std::vector<std::vector<u32>> gcom::LevelTemplate::read_tiles(std::string_view file)
+{
+    u32 tile_code{};
+    std::string line{};
+    std::ifstream fstream{ file.data() };
+    std::vector<std::vector<u32>> tile_data{};
+
+    while (std::getline(fstream, line)) // read each line from level file
+    {
+        std::istringstream sstream{ line };
+        std::vector<u32> row;
+        while (sstream >> tile_code) // read each word separated by spaces
+        {
+            row.push_back(tile_code);
+        }
+        tile_data.push_back(row);
+    }
+    return tile_data;
+}
@@ -1,55 +1,72 @@
 #include "GameCommon/Common.h"
 #include "GameCommon/Shader.h"
+#include <GameCommon/GLCounters.h>
 #include <GameCommon/ParticleGenerator.h>
 
 gcom::ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture,
                                          u32 amount)
-    : shader_{ shader }, texture_{ texture }, amount_{ amount }
+    : particles_{ amount }, amount_{ amount }, shader_{ shader }, texture_{ texture }
 {
     init();
 }
 
+gcom::ParticleGenerator::~ParticleGenerator()
+{
+    glDeleteVertexArrays(1, &VAO_);
+    glDeleteBuffers(1, &quad_VBO_);
+    glDeleteBuffers(1, &instance_VBO_);
+}
+
 void gcom::ParticleGenerator::update(float dt, GameObject& object, u32 new_particles,
                                    glm::vec2 offset)
 {
     // add new particles
     for (u32 i = 0; i < new_particles; ++i)
     {
-        int unused_particle = this->first_unused_particle();
-        this->respawn_particle(particles_[unused_particle], object, offset);
-    }
-    // update all particles
-    for (u32 i = 0; i < amount_; ++i)
-    {
-        Particle& p{ particles_[i] };
-        p.life -= dt; // reduce life
-        if (p.life > 0.0f)
-        {
-            // particle is still alive, thus update
-            p.pos -= p.velocity * dt;
-            p.color.a -= dt * 2.5f;
-        }
+        respawn_particle(object, offset);
     }
+    // update all live particles
+    particles_.update(dt);
 }
 
 // render all particles
 void gcom::ParticleGenerator::draw()
 {
-    // use additive blending to give it a 'glow' effect
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    shader_.use();
-    for (auto& particle : particles_)
+    const u32 count{ particles_.size() };
+    if (count == 0)
     {
-        if (particle.life > 0.0f)
-        {
-            shader_.set_vector2f("offset", particle.pos);
-            shader_.set_vector4f("color", particle.color);
-            texture_.bind();
-            glBindVertexArray(VAO_);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
-        }
+        return;
     }
+
+    instances_.resize(count);
+    const float* pos_x{ particles_.pos_x() };
+    const float* pos_y{ particles_.pos_y() };
+    const float* shade{ particles_.shade() };
+    const float* alpha{ particles_.alpha() };
+    for (u32 i = 0; i < count; ++i)
+    {
+        const glm::vec4 color{ shade[i], shade[i], shade[i], alpha[i] };
+        instances_[i] = Instance{ glm::vec2{ pos_x[i], pos_y[i] }, color };
+    }
+
+    // orphan last frame's storage so the driver doesn't wait until it was read
+    glBindBuffer(GL_ARRAY_BUFFER, instance_VBO_);
+    glBufferData(
+        GL_ARRAY_BUFFER, amount_ * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(
+        GL_ARRAY_BUFFER, 0, instances_.size() * sizeof(Instance), instances_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // use additive blending to give it a 'glow' effect, which also makes the
+    // drawing order of the particles irrelevant
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    shader_.use();
+    glActiveTexture(GL_TEXTURE0);
+    texture_.bind();
+    glBindVertexArray(VAO_);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(count));
+    ++gl_counters.draw_calls;
+    glBindVertexArray(0);
     // don't forget to reset to default blending mode
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
@@ -58,7 +75,6 @@ void gcom::ParticleGenerator::draw()
 void gcom::ParticleGenerator::init()
 {
     // set up mesh and attribute properties
-    u32 VBO;
     std::array particle_quad{ 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f,
                               1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
 
@@ -66,10 +82,11 @@ void gcom::ParticleGenerator::init()
                               1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f };
 
     glGenVertexArrays(1, &VAO_);
-    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &quad_VBO_);
+    glGenBuffers(1, &instance_VBO_);
     glBindVertexArray(VAO_);
     // fill mesh buffer
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_VBO_);
     glBufferData(GL_ARRAY_BUFFER,
                  sizeof(particle_quad),
                  particle_quad.data(),
@@ -78,52 +95,39 @@ void gcom::ParticleGenerator::init()
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(
         0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), reinterpret_cast<void*>(0));
-    glBindVertexArray(0);
-
-    // create this->amount default particle instances
-    for (u32 i = 0; i < amount_; ++i)
-        particles_.emplace_back(Particle{});
-}
 
-// stores the index of the last particle used (for quick access to next dead
-// particle)
-u32 last_used_particle = 0;
+    // per particle attributes, they advance once per quad
+    glBindBuffer(GL_ARRAY_BUFFER, instance_VBO_);
+    glBufferData(
+        GL_ARRAY_BUFFER, amount_ * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1,
+                          2,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(Instance),
+                          reinterpret_cast<void*>(offsetof(Instance, offset)));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2,
+                          4,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(Instance),
+                          reinterpret_cast<void*>(offsetof(Instance, color)));
+    glVertexAttribDivisor(2, 1);
 
-u32 gcom::ParticleGenerator::first_unused_particle()
-{
-    // first search from last used particle, this will usually return almost
-    // instantly
-    for (u32 i{ last_used_particle }; i < amount_; ++i)
-    {
-        if (particles_[i].life <= 0.0f)
-        {
-            last_used_particle = i;
-            return i;
-        }
-    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
 
-    // otherwise, do a linear search
-    for (u32 i{ 0 }; i < last_used_particle; ++i)
-    {
-        if (particles_[i].life <= 0.0f)
-        {
-            last_used_particle = i;
-            return i;
-        }
-    }
-    // all particles are taken, override the first one (note that if it repeatedly
-    // hits this case, more particles should be reserved)
-    last_used_particle = 0;
-    return 0;
+    instances_.reserve(amount_);
 }
 
-void gcom::ParticleGenerator::respawn_particle(Particle& particle, GameObject& object,
+void gcom::ParticleGenerator::respawn_particle(GameObject& object,
                                              const glm::vec2& offset)
 {
     float random{ ((std::rand() % 100) - 50) / 10.0f };
     float random_color{ 0.5f + ((std::rand() % 100) / 100.0f) };
-    particle.pos      = object.pos_ + random + offset;
-    particle.color    = glm::vec4(random_color, random_color, random_color, 1.0f);
-    particle.life     = 1.0f;
-    particle.velocity = object.velocity_ * 0.1f;
+    particles_.spawn(object.pos_ + random + offset, object.velocity_ * 0.1f,
+                     random_color);
 }
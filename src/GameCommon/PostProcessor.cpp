@@ -1,10 +1,12 @@
 #include <GameCommon/Common.h>
+#include <GameCommon/GLCounters.h>
 #include <GameCommon/Texture.h>
 #include <GameCommon/PostProcessor.h>
 
 gcom::PostProcessor::PostProcessor(const Shader& shader, u32 width, u32 height)
     : post_processing_shader_{ shader }, texture_{}, width_{ width },
-      height_{ height }, confuse_{ false }, chaos_{ false }, shake_{ false }
+      height_{ height }, shake_{ false }, confuse_{ false }, chaos_{ false },
+      effect_uniforms_{ UniformBlock::Effects, sizeof(EffectUniforms) }
 {
     // initialize renderbuffer/framebuffer object
     glGenFramebuffers(1, &MSFBO_);
@@ -44,35 +46,34 @@ gcom::PostProcessor::PostProcessor(const Shader& shader, u32 width, u32 height)
     // initialize render data and uniforms
     init_render_data();
     post_processing_shader_.set_integer("scene", 0, true);
-    float offset{ 1.0f / 300.0f };
-    std::array<std::array<float, 2>, 9> offsets = { {
-        { { -offset, offset } },  // top-left
-        { { 0.0f, offset } },     // top-center
-        { { offset, offset } },   // top-right
-        { { -offset, 0.0f } },    // center-left
-        { { 0.0f, 0.0f } },       // center-center
-        { { offset, 0.0f } },     // center-right
-        { { -offset, -offset } }, // bottom-left
-        { { 0.0f, -offset } },    // bottom-center
-        { { offset, -offset } }   // bottom-right
-    } };
-    glUniform2fv(glGetUniformLocation(post_processing_shader_.id, "offsets"),
-                 9,
-                 reinterpret_cast<float*>(offsets.data()));
 
-    std::array edge_kernel{ -1, -1, -1, -1, 8, -1, -1, -1, -1 };
-    glUniform1iv(glGetUniformLocation(post_processing_shader_.id, "edge_kernel"),
-                 9,
-                 edge_kernel.data());
-
-    std::array blur_kernel{ 1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
-                            2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
-                            1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f };
-    glUniform1fv(
-        glGetUniformLocation(this->post_processing_shader_.id, "blur_kernel"),
-        9,
-        blur_kernel.data());
+    // the kernels never change, one upload for the Effects block
+    EffectUniforms effects{};
+    const float offset{ 1.0f / 300.0f };
+    const std::array<glm::vec2, 9> offsets{
+        glm::vec2{ -offset, offset },  // top-left
+        glm::vec2{ 0.0f, offset },     // top-center
+        glm::vec2{ offset, offset },   // top-right
+        glm::vec2{ -offset, 0.0f },    // center-left
+        glm::vec2{ 0.0f, 0.0f },       // center-center
+        glm::vec2{ offset, 0.0f },     // center-right
+        glm::vec2{ -offset, -offset }, // bottom-left
+        glm::vec2{ 0.0f, -offset },    // bottom-center
+        glm::vec2{ offset, -offset }   // bottom-right
+    };
+    const std::array edge_kernel{ -1, -1, -1, -1, 8, -1, -1, -1, -1 };
+    const std::array blur_kernel{ 1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
+                                  2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
+                                  1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f };
+    for (size_t i{ 0 }; i < 9; ++i)
+    {
+        effects.offsets[i].value     = offsets[i];
+        effects.edge_kernel[i].value = edge_kernel[i];
+        effects.blur_kernel[i].value = blur_kernel[i];
+    }
+    effect_uniforms_.update(effects);
 }
+
 void gcom::PostProcessor::begin_render()
 {
     glBindFramebuffer(GL_FRAMEBUFFER, MSFBO_);
@@ -113,6 +114,7 @@ void gcom::PostProcessor::render(float time)
     texture_.bind();
     glBindVertexArray(VAO_);
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    ++gl_counters.draw_calls;
     glBindVertexArray(0);
 }
 
@@ -0,0 +1,8 @@
+#include <GameCommon/PowerUpKind.h>
+#include <GameCommon/Types.h>
+
+bool gcom::should_spawn(const PowerUpKind& kind)
+{
+    u32 random{ std::rand() % kind.chance };
+    return random == 0;
+}
@@ -0,0 +1,130 @@
+#include <GameCommon/ProgramCache.h>
+#include <GameCommon/Common.h>
+
+#include <filesystem>
+
+namespace
+{
+constexpr std::array<char, 4> MAGIC{ 'P', 'N', 'P', 'B' };
+constexpr u32 VERSION{ 1 };
+
+// Starts every cache file, followed by `size` bytes of binary
+struct CacheHeader
+{
+    std::array<char, 4> magic;
+    u32 version;
+    u64 key;
+    u32 format; // what glGetProgramBinary() said the binary is
+    u32 size;
+};
+
+// FNV-1a, continuing from `hash`
+u64 hash_bytes(u64 hash, std::string_view bytes)
+{
+    for (const char c : bytes)
+    {
+        hash ^= static_cast<u8>(c);
+        hash *= 1099511628211ull;
+    }
+    // so "ab" + "c" and "a" + "bc" differ
+    hash ^= bytes.size();
+    return hash * 1099511628211ull;
+}
+
+std::string_view gl_string(u32 name)
+{
+    const auto* string{ reinterpret_cast<const char*>(glGetString(name)) };
+    return string ? std::string_view{ string } : std::string_view{};
+}
+} // namespace
+
+std::string gcom::ProgramCache::directory_{};
+u64 gcom::ProgramCache::driver_key_{ 0 };
+
+void gcom::ProgramCache::open(std::string_view directory)
+{
+    GLint formats{ 0 };
+    if (GLAD_GL_ARB_get_program_binary)
+    {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    if (formats <= 0)
+    {
+        return;
+    }
+
+    directory_  = directory;
+    driver_key_ = 14695981039346656037ull;
+    for (const u32 name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+    {
+        driver_key_ = hash_bytes(driver_key_, gl_string(name));
+    }
+}
+
+u64 gcom::ProgramCache::key(std::string_view vertex_source,
+                            std::string_view fragment_source,
+                            std::string_view geometry_source)
+{
+    u64 key{ driver_key_ };
+    for (const std::string_view source : { vertex_source,
+                                           fragment_source,
+                                           geometry_source })
+    {
+        key = hash_bytes(key, source);
+    }
+    return key;
+}
+
+bool gcom::ProgramCache::load(u32 program, u64 key)
+{
+    std::ifstream file{ path(key), std::ios::binary };
+    CacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader)) ||
+        header.magic != MAGIC || header.version != VERSION || header.key != key)
+    {
+        return false;
+    }
+    std::vector<char> binary(header.size);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+    {
+        return false;
+    }
+
+    glProgramBinary(
+        program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked{ GL_FALSE };
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+}
+
+void gcom::ProgramCache::store(u32 program, u64 key)
+{
+    GLint length{ 0 };
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLsizei written{ 0 };
+    GLenum format{ 0 };
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+
+    // a cache that can't be written only costs the next start its compile time
+    std::error_code error{};
+    std::filesystem::create_directories(directory_, error);
+    std::ofstream file{ path(key), std::ios::binary };
+    const CacheHeader header{
+        MAGIC, VERSION, key, format, static_cast<u32>(written)
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+    file.write(binary.data(), written);
+}
+
+std::string gcom::ProgramCache::path(u64 key)
+{
+    std::array<char, 16> hex{};
+    const auto [end, error]{ std::to_chars(
+        hex.data(), hex.data() + hex.size(), key, 16) };
+    return directory_ + "/" + std::string{ hex.data(), end } + ".bin";
+}
@@ -4,54 +4,73 @@
 #include "GameCommon/Shader.h"
 #include "GameCommon/Texture.h"
 
-std::map<std::string_view, gcom::Shader> gcom::ResourceManager::shaders{};
-std::map<std::string_view, gcom::Texture2D> gcom::ResourceManager::textures{};
+gcom::ResourceRegistry<gcom::Shader> gcom::ResourceManager::shaders{};
+gcom::ResourceRegistry<gcom::Texture2D> gcom::ResourceManager::textures{};
 
 gcom::Shader gcom::ResourceManager::load_shader(std::string_view v_shader_file,
                                             std::string_view f_shader_file,
                                             std::string_view g_shader_file,
                                             std::string_view name)
 {
-    shaders[name] =
-        load_shader_from_file(v_shader_file, f_shader_file, g_shader_file);
-    return shaders[name];
+    return shaders.get(shaders.set(
+        name, load_shader_from_file(v_shader_file, f_shader_file, g_shader_file)));
 }
 
-gcom::Shader gcom::ResourceManager::get_shader(std::string_view name)
+gcom::Handle<gcom::Shader> gcom::ResourceManager::shader_handle(
+    std::string_view name)
 {
-    return shaders[name];
+    return shaders.intern(name);
+}
+
+gcom::Handle<gcom::Texture2D> gcom::ResourceManager::texture_handle(
+    std::string_view name)
+{
+    return textures.intern(name);
+}
+
+gcom::Shader& gcom::ResourceManager::get_shader(Handle<Shader> handle)
+{
+    return shaders.get(handle);
+}
+
+gcom::Shader& gcom::ResourceManager::get_shader(std::string_view name)
+{
+    return shaders.get(shaders.intern(name));
 }
 
 gcom::Texture2D gcom::ResourceManager::load_texture(std::string_view file, bool alpha,
                                                 std::string_view name)
 {
-    textures[name] = load_texture_from_file(file, alpha);
-    return textures[name];
+    return textures.get(textures.set(name, load_texture_from_file(file, alpha)));
+}
+
+const gcom::Texture2D& gcom::ResourceManager::get_texture(Handle<Texture2D> handle)
+{
+    return textures.get(handle);
 }
 
-gcom::Texture2D gcom::ResourceManager::get_texture(std::string_view name)
+const gcom::Texture2D& gcom::ResourceManager::get_texture(std::string_view name)
 {
-    return textures[name];
+    return textures.get(textures.intern(name));
 }
 
 void gcom::ResourceManager::clear()
 {
-    for (auto& shader : shaders)
+    for (const Shader& shader : shaders.resources())
     {
-        glDeleteProgram(shader.second.id);
+        glDeleteProgram(shader.id);
     }
-    for (auto& texture : textures)
+    for (const Texture2D& texture : textures.resources())
     {
-        u32 id{ texture.second.id() };
+        u32 id{ texture.id() };
         glDeleteTextures(1, &id);
     }
 }
 
 void gcom::ResourceManager::print_all_textures() 
 {
-    for (const auto& pair : textures)
+    for (const std::string& texture_name : textures.names())
     {
-        std::string_view texture_name{ pair.first };
         std::cout << texture_name << "\n";
     }
 }
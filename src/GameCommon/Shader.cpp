@@ -1,6 +1,11 @@
 #include <GameCommon/Shader.h>
 
 #include <GameCommon/Common.h>
+#include <GameCommon/GLCounters.h>
+#include <GameCommon/ProgramCache.h>
+#include <GameCommon/UniformBuffer.h>
+#include <cassert>
+#include <cstring>
 #include <iostream>
 
 gcom::Shader& gcom::Shader::use()
@@ -13,53 +18,156 @@ void gcom::Shader::compile(std::string_view vertex_source,
                          std::string_view fragment_source,
                          std::string_view geometry_source)
 {
-    u32 vertex_shader{};
-    u32 fragment_shader{};
-    u32 geo_shader{};
+    begin_compile(vertex_source, fragment_source, geometry_source);
+    finish_compile();
+}
 
-    // Vertex shader
-    vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-    const char* v_source{ vertex_source.data() };
-    glShaderSource(vertex_shader, 1, &v_source, nullptr);
-    glCompileShader(vertex_shader);
-    check_compile_errors(vertex_shader, "VERTEX");
+void gcom::Shader::begin_compile(std::string_view vertex_source,
+                                 std::string_view fragment_source,
+                                 std::string_view geometry_source)
+{
+    id      = glCreateProgram();
+    stages_ = {};
+    if (ProgramCache::is_open())
+    {
+        cache_key_ =
+            ProgramCache::key(vertex_source, fragment_source, geometry_source);
+        if (ProgramCache::load(id, cache_key_))
+        {
+            return;
+        }
+        // the driver may drop what glGetProgramBinary() needs without this
+        glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
 
-    // Fragment shader
-    fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-    const char* f_source{ fragment_source.data() };
-    glShaderSource(fragment_shader, 1, &f_source, nullptr);
-    glCompileShader(fragment_shader);
-    check_compile_errors(fragment_shader, "FRAGMENT");
+    constexpr std::array<u32, 3> STAGE_TYPES{ GL_VERTEX_SHADER,
+                                              GL_FRAGMENT_SHADER,
+                                              GL_GEOMETRY_SHADER };
+    const std::array<std::string_view, 3> sources{ vertex_source,
+                                                   fragment_source,
+                                                   geometry_source };
+    for (size_t i{ 0 }; i < stages_.size(); ++i)
+    {
+        // If geometry shader source code is given, also compile geo shader
+        if (sources[i].empty())
+        {
+            continue;
+        }
+        stages_[i] = glCreateShader(STAGE_TYPES[i]);
+        const char* source{ sources[i].data() };
+        glShaderSource(stages_[i], 1, &source, nullptr);
+        glCompileShader(stages_[i]);
+        glAttachShader(id, stages_[i]);
+    }
+
+    // Asking for the status right away would wait for the compile, so errors are
+    // checked by finish_compile()
+    glLinkProgram(id);
+}
 
-    // If geometry shader source code is given, also compile geo shader
-    if (!geometry_source.empty())
+bool gcom::Shader::ready() const
+{
+    if (!GLAD_GL_KHR_parallel_shader_compile)
     {
-        geo_shader = glCreateShader(GL_GEOMETRY_SHADER);
-        const char* g_source{ geometry_source.data() };
-        glShaderSource(geo_shader, 1, &g_source, nullptr);
-        glCompileShader(geo_shader);
-        check_compile_errors(geo_shader, "GEOMETRY");
+        return true;
     }
+    GLint done{ GL_FALSE };
+    glGetProgramiv(id, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
 
-    // Shader program
-    id = glCreateProgram();
-    glAttachShader(id, vertex_shader);
-    glAttachShader(id, fragment_shader);
-    if (!geometry_source.empty())
+void gcom::Shader::finish_compile()
+{
+    if (stages_[0] != 0)
     {
-        glAttachShader(id, geo_shader);
+        constexpr std::array<std::string_view, 3> STAGE_NAMES{ "VERTEX",
+                                                               "FRAGMENT",
+                                                               "GEOMETRY" };
+        for (size_t i{ 0 }; i < stages_.size(); ++i)
+        {
+            if (stages_[i] != 0)
+            {
+                check_compile_errors(stages_[i], STAGE_NAMES[i]);
+            }
+        }
+        check_compile_errors(id, "PROGRAM");
+
+        // Delete the shaders as they're linked into our program now and no
+        // longer necessary
+        for (u32& stage : stages_)
+        {
+            if (stage != 0)
+            {
+                glDeleteShader(stage);
+                stage = 0;
+            }
+        }
+
+        GLint linked{ GL_FALSE };
+        glGetProgramiv(id, GL_LINK_STATUS, &linked);
+        if (ProgramCache::is_open() && linked == GL_TRUE)
+        {
+            ProgramCache::store(id, cache_key_);
+        }
     }
 
-    glLinkProgram(id);
-    check_compile_errors(id, "PROGRAM");
+    reflect_uniforms();
+    bind_uniform_blocks();
+}
+
+void gcom::Shader::set(Uniform<float> uniform, float value)
+{
+    if (update_cache(uniform.index_, &value, sizeof(value)))
+    {
+        glUniform1f((*uniforms_)[uniform.index_].location, value);
+    }
+}
+
+void gcom::Shader::set(Uniform<int> uniform, int value)
+{
+    if (update_cache(uniform.index_, &value, sizeof(value)))
+    {
+        glUniform1i((*uniforms_)[uniform.index_].location, value);
+    }
+}
+
+void gcom::Shader::set(Uniform<glm::vec2> uniform, const glm::vec2& value)
+{
+    if (update_cache(uniform.index_, &value, sizeof(value)))
+    {
+        glUniform2f((*uniforms_)[uniform.index_].location, value.x, value.y);
+    }
+}
+
+void gcom::Shader::set(Uniform<glm::vec3> uniform, const glm::vec3& value)
+{
+    if (update_cache(uniform.index_, &value, sizeof(value)))
+    {
+        glUniform3f(
+            (*uniforms_)[uniform.index_].location, value.x, value.y, value.z);
+    }
+}
+
+void gcom::Shader::set(Uniform<glm::vec4> uniform, const glm::vec4& value)
+{
+    if (update_cache(uniform.index_, &value, sizeof(value)))
+    {
+        glUniform4f((*uniforms_)[uniform.index_].location,
+                    value.x,
+                    value.y,
+                    value.z,
+                    value.w);
+    }
+}
 
-    // Delete the shaders as they're linked into our program now and no longer
-    // necessary
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-    if (!geometry_source.empty())
+void gcom::Shader::set(Uniform<glm::mat4> uniform, const glm::mat4& value)
+{
+    if (update_cache(uniform.index_, &value, sizeof(value)))
     {
-        glDeleteShader(geo_shader);
+        glUniformMatrix4fv((*uniforms_)[uniform.index_].location,
+                           1,
+                           false,
+                           glm::value_ptr(value));
     }
 }
 
@@ -69,7 +177,7 @@ void gcom::Shader::set_float(std::string_view name, float value, bool use_shader
     {
         use();
     }
-    glUniform1f(glGetUniformLocation(id, name.data()), value);
+    set(uniform<float>(name), value);
 }
 
 void gcom::Shader::set_integer(std::string_view name, int value, bool use_shader)
@@ -78,17 +186,13 @@ void gcom::Shader::set_integer(std::string_view name, int value, bool use_shader
     {
         use();
     }
-    glUniform1f(glGetUniformLocation(id, name.data()), value);
+    set(uniform<int>(name), value);
 }
 
 void gcom::Shader::set_vector2f(std::string_view name, float x, float y,
                               bool use_shader)
 {
-    if (use_shader)
-    {
-        use();
-    }
-    glUniform2f(glGetUniformLocation(id, name.data()), x, y);
+    set_vector2f(name, glm::vec2{ x, y }, use_shader);
 }
 
 void gcom::Shader::set_vector2f(std::string_view name, const glm::vec2& value,
@@ -98,17 +202,13 @@ void gcom::Shader::set_vector2f(std::string_view name, const glm::vec2& value,
     {
         use();
     }
-    glUniform2f(glGetUniformLocation(id, name.data()), value.x, value.y);
+    set(uniform<glm::vec2>(name), value);
 }
 
 void gcom::Shader::set_vector3f(std::string_view name, float x, float y, float z,
                               bool use_shader)
 {
-    if (use_shader)
-    {
-        use();
-    }
-    glUniform3f(glGetUniformLocation(id, name.data()), x, y, z);
+    set_vector3f(name, glm::vec3{ x, y, z }, use_shader);
 }
 
 void gcom::Shader::set_vector3f(std::string_view name, const glm::vec3& value,
@@ -118,17 +218,13 @@ void gcom::Shader::set_vector3f(std::string_view name, const glm::vec3& value,
     {
         use();
     }
-    glUniform3f(glGetUniformLocation(id, name.data()), value.x, value.y, value.z);
+    set(uniform<glm::vec3>(name), value);
 }
 
 void gcom::Shader::set_vector4f(std::string_view name, float x, float y, float z,
                               float w, bool use_shader)
 {
-    if (use_shader)
-    {
-        use();
-    }
-    glUniform4f(glGetUniformLocation(id, name.data()), x, y, z, w);
+    set_vector4f(name, glm::vec4{ x, y, z, w }, use_shader);
 }
 
 void gcom::Shader::set_vector4f(std::string_view name, const glm::vec4& value,
@@ -138,9 +234,9 @@ void gcom::Shader::set_vector4f(std::string_view name, const glm::vec4& value,
     {
         use();
     }
-    glUniform4f(
-        glGetUniformLocation(id, name.data()), value.x, value.y, value.z, value.w);
+    set(uniform<glm::vec4>(name), value);
 }
+
 void gcom::Shader::set_matrix4(std::string_view name, const glm::mat4& matrix,
                              bool use_shader)
 {
@@ -148,8 +244,96 @@ void gcom::Shader::set_matrix4(std::string_view name, const glm::mat4& matrix,
     {
         use();
     }
-    glUniformMatrix4fv(
-        glGetUniformLocation(id, name.data()), 1, false, glm::value_ptr(matrix));
+    set(uniform<glm::mat4>(name), matrix);
+}
+
+void gcom::Shader::reflect_uniforms()
+{
+    // a fresh table, copies of the shader made before compile() keep the old one
+    uniforms_ = std::make_shared<std::vector<UniformSlot>>();
+
+    int count{};
+    glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+    for (int i{ 0 }; i < count; ++i)
+    {
+        std::array<char, 256> name{};
+        GLsizei length{};
+        GLint size{};
+        GLenum type{};
+        glGetActiveUniform(id,
+                           static_cast<GLuint>(i),
+                           static_cast<GLsizei>(name.size()),
+                           &length,
+                           &size,
+                           &type,
+                           name.data());
+
+        UniformSlot slot{};
+        slot.name = std::string{ name.data(), static_cast<size_t>(length) };
+        // arrays are reported as "name[0]"
+        if (slot.name.ends_with("[0]"))
+        {
+            slot.name.resize(slot.name.size() - 3);
+        }
+        slot.location = glGetUniformLocation(id, name.data());
+        slot.type     = type;
+        ++gl_counters.location_lookups;
+
+        // uniforms in blocks have no location
+        if (slot.location >= 0)
+        {
+            uniforms_->push_back(std::move(slot));
+        }
+    }
+}
+
+void gcom::Shader::bind_uniform_blocks()
+{
+    for (const UniformBlock block : { UniformBlock::View, UniformBlock::Effects })
+    {
+        const std::string name{ uniform_block_name(block) };
+        const u32 index{ glGetUniformBlockIndex(id, name.c_str()) };
+        if (index != GL_INVALID_INDEX)
+        {
+            glUniformBlockBinding(id, index, static_cast<u32>(block));
+        }
+    }
+}
+
+i32 gcom::Shader::find_uniform(std::string_view name,
+                               bool (*type_matches)(u32)) const
+{
+    // a handful of uniforms per shader, a linear search beats hashing
+    for (size_t i{ 0 }; i < uniforms_->size(); ++i)
+    {
+        const UniformSlot& slot{ (*uniforms_)[i] };
+        if (slot.name == name)
+        {
+            assert(type_matches(slot.type) && "uniform set with the wrong type");
+            return type_matches(slot.type) ? static_cast<i32>(i) : -1;
+        }
+    }
+    return -1;
+}
+
+bool gcom::Shader::update_cache(i32 index, const void* value, size_t bytes)
+{
+    if (index < 0)
+    {
+        return false;
+    }
+
+    UniformSlot& slot{ (*uniforms_)[index] };
+    if (slot.has_value && std::memcmp(slot.value.data(), value, bytes) == 0)
+    {
+        ++gl_counters.uniform_skips;
+        return false;
+    }
+
+    std::memcpy(slot.value.data(), value, bytes);
+    slot.has_value = true;
+    ++gl_counters.uniform_uploads;
+    return true;
 }
 
 void gcom::Shader::check_compile_errors(u32 object, std::string_view type)
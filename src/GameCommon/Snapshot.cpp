@@ -0,0 +1,219 @@
+#include <GameCommon/Snapshot.h>
+#include <GameCommon/Types.h>
+
+#include <cmath>
+
+i32 gcom::quantize(float value)
+{
+    return static_cast<i32>(std::lround(value * SNAPSHOT_SCALE));
+}
+
+float gcom::dequantize(i32 value) { return static_cast<float>(value) / SNAPSHOT_SCALE; }
+
+void gcom::Snapshot::set_ball(const BallDesc& ball)
+{
+    fields[BALL_POS_X] = quantize(ball.pos.x);
+    fields[BALL_POS_Y] = quantize(ball.pos.y);
+    fields[BALL_VEL_X] = quantize(ball.velocity.x);
+    fields[BALL_VEL_Y] = quantize(ball.velocity.y);
+    fields[BALL_STUCK] = ball.stuck ? 1 : 0;
+}
+
+BallDesc gcom::Snapshot::ball(float radius, const glm::vec2& size) const
+{
+    return BallDesc{ radius,
+                     fields[BALL_STUCK] != 0,
+                     glm::vec2{ dequantize(fields[BALL_POS_X]),
+                                dequantize(fields[BALL_POS_Y]) },
+                     glm::vec2{ dequantize(fields[BALL_VEL_X]),
+                                dequantize(fields[BALL_VEL_Y]) },
+                     size };
+}
+
+void gcom::Snapshot::set_paddle(u32 paddle, const glm::vec2& pos, u32 lives)
+{
+    const u32 first{ PADDLE_ONE_POS_X + paddle * FIELDS_PER_PADDLE };
+    fields[first]     = quantize(pos.x);
+    fields[first + 1] = quantize(pos.y);
+    fields[first + 2] = static_cast<i32>(lives);
+}
+
+glm::vec2 gcom::Snapshot::paddle_pos(u32 paddle) const
+{
+    const u32 first{ PADDLE_ONE_POS_X + paddle * FIELDS_PER_PADDLE };
+    return glm::vec2{ dequantize(fields[first]), dequantize(fields[first + 1]) };
+}
+
+u32 gcom::Snapshot::paddle_lives(u32 paddle) const
+{
+    return static_cast<u32>(fields[PADDLE_ONE_LIVES + paddle * FIELDS_PER_PADDLE]);
+}
+
+void gcom::SnapshotHistory::store(const Snapshot& snapshot)
+{
+    snapshots_[snapshot.sequence % SIZE] = snapshot;
+    used_[snapshot.sequence % SIZE]      = true;
+}
+
+const gcom::Snapshot* gcom::SnapshotHistory::find(u16 sequence) const
+{
+    const u32 index{ sequence % SIZE };
+    if (!used_[index] || snapshots_[index].sequence != sequence)
+    {
+        return nullptr;
+    }
+    return &snapshots_[index];
+}
+
+void gcom::SnapshotHistory::clear() { used_.fill(false); }
+
+namespace
+{
+// Wire format:
+//   u16    sequence
+//   u8     distance back to the baseline sequence, 0 for a full snapshot
+//   u8     events
+//   varint input ack
+//   varint mask of the fields that differ from the baseline
+//   varint zigzag(field - baseline field) for every field in the mask, in order
+
+void write_varint(u32 value, std::vector<u8>& out)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<u8>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<u8>(value));
+}
+
+bool read_varint(std::span<const u8> in, size_t& offset, u32& value)
+{
+    value = 0;
+    for (u32 shift{ 0 }; shift < 35; shift += 7)
+    {
+        if (offset >= in.size())
+        {
+            return false;
+        }
+        const u8 byte{ in[offset++] };
+        value |= static_cast<u32>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Small negative deltas become small unsigned numbers: 0, -1, 1, -2, ... -> 0, 1,
+// 2, 3, ...
+u32 zigzag(i32 value)
+{
+    return (static_cast<u32>(value) << 1) ^ static_cast<u32>(value >> 31);
+}
+
+i32 unzigzag(u32 value)
+{
+    return static_cast<i32>(value >> 1) ^ -static_cast<i32>(value & 1);
+}
+
+constexpr u16 MAX_BASELINE_DISTANCE{ 255 };
+} // namespace
+
+void gcom::encode_snapshot(const Snapshot& current, const Snapshot* baseline,
+                           std::vector<u8>& out)
+{
+    const u16 distance{ baseline ? static_cast<u16>(current.sequence -
+                                                    baseline->sequence)
+                                 : u16{ 0 } };
+    if (distance == 0 || distance > MAX_BASELINE_DISTANCE)
+    {
+        baseline = nullptr;
+    }
+
+    static const Snapshot empty{};
+    const Snapshot& base{ baseline ? *baseline : empty };
+
+    out.push_back(static_cast<u8>(current.sequence & 0xff));
+    out.push_back(static_cast<u8>(current.sequence >> 8));
+    out.push_back(baseline ? static_cast<u8>(distance) : u8{ 0 });
+    out.push_back(current.events);
+    write_varint(current.input_ack, out);
+
+    u32 mask{ 0 };
+    for (u32 field{ 0 }; field < Snapshot::FIELD_COUNT; ++field)
+    {
+        if (current.fields[field] != base.fields[field])
+        {
+            mask |= 1u << field;
+        }
+    }
+    write_varint(mask, out);
+
+    for (u32 field{ 0 }; field < Snapshot::FIELD_COUNT; ++field)
+    {
+        if (mask & (1u << field))
+        {
+            // wrapping subtraction, the decoder wraps back the same way
+            write_varint(zigzag(static_cast<i32>(
+                             static_cast<u32>(current.fields[field]) -
+                             static_cast<u32>(base.fields[field]))),
+                         out);
+        }
+    }
+}
+
+std::optional<gcom::Snapshot> gcom::decode_snapshot(std::span<const u8> in,
+                                                    const SnapshotHistory& history)
+{
+    if (in.size() < 4)
+    {
+        return std::nullopt;
+    }
+
+    Snapshot snapshot{};
+    snapshot.sequence = static_cast<u16>(in[0] | (in[1] << 8));
+    const u8 distance{ in[2] };
+    snapshot.events = in[3];
+
+    if (distance != 0)
+    {
+        const Snapshot* baseline{ history.find(
+            static_cast<u16>(snapshot.sequence - distance)) };
+        if (!baseline)
+        {
+            return std::nullopt;
+        }
+        snapshot.fields = baseline->fields;
+    }
+
+    size_t offset{ 4 };
+    u32 mask{ 0 };
+    if (!read_varint(in, offset, snapshot.input_ack) ||
+        !read_varint(in, offset, mask) || mask >= (1u << Snapshot::FIELD_COUNT))
+    {
+        return std::nullopt;
+    }
+
+    for (u32 field{ 0 }; field < Snapshot::FIELD_COUNT; ++field)
+    {
+        if (mask & (1u << field))
+        {
+            u32 delta{ 0 };
+            if (!read_varint(in, offset, delta))
+            {
+                return std::nullopt;
+            }
+            snapshot.fields[field] =
+                static_cast<i32>(static_cast<u32>(snapshot.fields[field]) +
+                                 static_cast<u32>(unzigzag(delta)));
+        }
+    }
+
+    if (offset != in.size())
+    {
+        return std::nullopt;
+    }
+    return snapshot;
+}
@@ -0,0 +1,109 @@
+#include <GameCommon/SnapshotBuffer.h>
+#include <GameCommon/Types.h>
+
+namespace
+{
+// Offset samples further than this from the estimate mean the server clock jumped
+// (e.g. a new match), so the estimate restarts instead of drifting over slowly
+constexpr double CLOCK_RESYNC_THRESHOLD{ 0.25 };
+constexpr double CLOCK_SMOOTHING{ 0.05 };
+} // namespace
+
+double gcom::SnapshotBuffer::server_time(const Snapshot& snapshot)
+{
+    return snapshot.fields[Snapshot::SERVER_TIME_MS] / 1000.0;
+}
+
+void gcom::SnapshotBuffer::push(const Snapshot& snapshot, double now)
+{
+    if (count_ > 0)
+    {
+        const double newest{ server_time(at(count_ - 1)) };
+        if (server_time(snapshot) < newest - CLOCK_RESYNC_THRESHOLD)
+        {
+            clear(); // the server's match clock started over
+        }
+        else if (server_time(snapshot) <= newest)
+        {
+            return;
+        }
+    }
+
+    const double offset{ now - server_time(snapshot) };
+    if (!clock_offset_ || std::abs(offset - *clock_offset_) > CLOCK_RESYNC_THRESHOLD)
+    {
+        clock_offset_ = offset;
+    }
+    else
+    {
+        *clock_offset_ += (offset - *clock_offset_) * CLOCK_SMOOTHING;
+    }
+
+    if (count_ == SIZE)
+    {
+        first_ = (first_ + 1) % SIZE; // overwrite the oldest
+        --count_;
+    }
+    snapshots_[(first_ + count_) % SIZE] = snapshot;
+    ++count_;
+}
+
+std::optional<gcom::SnapshotBuffer::Sample>
+gcom::SnapshotBuffer::sample(double now, double delay, double max_extrapolation,
+                             float ball_radius, const glm::vec2& ball_size) const
+{
+    if (count_ == 0)
+    {
+        return std::nullopt;
+    }
+
+    const double render_time{ now - *clock_offset_ - delay };
+
+    // Newest snapshot at or before the render time, or the oldest one we still have
+    size_t from{ 0 };
+    while (from + 1 < count_ && server_time(at(from + 1)) <= render_time)
+    {
+        ++from;
+    }
+
+    const Snapshot& a{ at(from) };
+    Sample sample{ a.ball(ball_radius, ball_size), {} };
+    for (u32 paddle{ 0 }; paddle < Snapshot::PADDLE_COUNT; ++paddle)
+    {
+        sample.paddles[paddle] = a.paddle_pos(paddle);
+    }
+
+    if (from + 1 == count_)
+    {
+        // The next snapshot is late
+        const double ahead{ std::clamp(
+            render_time - server_time(a), 0.0, max_extrapolation) };
+        if (!sample.ball.stuck)
+        {
+            sample.ball.pos += sample.ball.velocity * static_cast<float>(ahead);
+        }
+        return sample;
+    }
+
+    const Snapshot& b{ at(from + 1) };
+    const double span{ server_time(b) - server_time(a) };
+    const float t{ static_cast<float>(
+        std::clamp((render_time - server_time(a)) / span, 0.0, 1.0)) };
+
+    const BallDesc to{ b.ball(ball_radius, ball_size) };
+    sample.ball.pos += (to.pos - sample.ball.pos) * t;
+    sample.ball.velocity += (to.velocity - sample.ball.velocity) * t;
+    for (u32 paddle{ 0 }; paddle < Snapshot::PADDLE_COUNT; ++paddle)
+    {
+        const glm::vec2 from_pos{ sample.paddles[paddle] };
+        sample.paddles[paddle] = from_pos + (b.paddle_pos(paddle) - from_pos) * t;
+    }
+    return sample;
+}
+
+void gcom::SnapshotBuffer::clear()
+{
+    first_ = 0;
+    count_ = 0;
+    clock_offset_.reset();
+}
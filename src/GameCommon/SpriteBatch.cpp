@@ -0,0 +1,160 @@
+#include <GameCommon/SpriteBatch.h>
+#include <GameCommon/Common.h>
+#include <GameCommon/GLCounters.h>
+
+gcom::SpriteBatch::SpriteBatch(const Shader& shader) : shader_{ shader }
+{
+    init_render_data();
+}
+
+gcom::SpriteBatch::~SpriteBatch()
+{
+    glDeleteVertexArrays(1, &quad_VAO_);
+    glDeleteBuffers(1, &quad_VBO_);
+    glDeleteBuffers(1, &instance_VBO_);
+}
+
+void gcom::SpriteBatch::begin_frame() { stats_ = Stats{}; }
+
+void gcom::SpriteBatch::add(const Texture2D& texture, const glm::vec2& position,
+                            const glm::vec2& size, float rotate,
+                            const glm::vec3& color, u32 layer)
+{
+    const Instance instance{ glm::vec4{ position, size },
+                             glm::vec4{ color, glm::radians(rotate) } };
+    sprites_.push_back(Sprite{ layer, texture.id(), instance });
+}
+
+void gcom::SpriteBatch::flush()
+{
+    if (sprites_.empty())
+    {
+        return;
+    }
+
+    const auto start{ std::chrono::steady_clock::now() };
+
+    // Stable, so sprites sharing a layer and texture keep the order they came in
+    std::stable_sort(sprites_.begin(),
+                     sprites_.end(),
+                     [](const Sprite& a, const Sprite& b)
+                     {
+                         return a.layer != b.layer ? a.layer < b.layer
+                                                   : a.texture < b.texture;
+                     });
+
+    instances_.clear();
+    for (const Sprite& sprite : sprites_)
+    {
+        instances_.push_back(sprite.instance);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instance_VBO_);
+    if (instances_.size() > instance_capacity_)
+    {
+        instance_capacity_ = std::max(instances_.size(), instance_capacity_ * 2);
+    }
+    // Orphan last frame's storage so the driver doesn't wait for it to be read
+    glBufferData(GL_ARRAY_BUFFER,
+                 instance_capacity_ * sizeof(Instance),
+                 nullptr,
+                 GL_STREAM_DRAW);
+    glBufferSubData(
+        GL_ARRAY_BUFFER, 0, instances_.size() * sizeof(Instance), instances_.data());
+
+    shader_.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(quad_VAO_);
+
+    // One instanced draw per run of sprites with the same layer and texture
+    size_t first{ 0 };
+    while (first < sprites_.size())
+    {
+        size_t last{ first + 1 };
+        while (last < sprites_.size() &&
+               sprites_[last].layer == sprites_[first].layer &&
+               sprites_[last].texture == sprites_[first].texture)
+        {
+            ++last;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, sprites_[first].texture);
+        set_instance_offset(first);
+        glDrawArraysInstanced(
+            GL_TRIANGLES, 0, 6, static_cast<GLsizei>(last - first));
+        ++stats_.draw_calls;
+        ++gl_counters.draw_calls;
+
+        first = last;
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    stats_.sprites += static_cast<u32>(sprites_.size());
+    sprites_.clear();
+
+    stats_.cpu_ms += std::chrono::duration<double, std::milli>{
+        std::chrono::steady_clock::now() - start
+    }.count();
+}
+
+void gcom::SpriteBatch::init_render_data()
+{
+    // Same unit quad as SpriteRenderer
+    constexpr std::array vertices{
+        // pos              // tex
+        0.0f, 1.0f, 0.0f, 1.0f, // bottom-left
+        1.0f, 0.0f, 1.0f, 0.0f, // top-right
+        0.0f, 0.0f, 0.0f, 0.0f, // top-left
+
+        0.0f, 1.0f, 0.0f, 1.0f, // bottom-left
+        1.0f, 1.0f, 1.0f, 1.0f, // bottom-right
+        1.0f, 0.0f, 1.0f, 0.0f  // top-right
+    };
+
+    glGenVertexArrays(1, &quad_VAO_);
+    glGenBuffers(1, &quad_VBO_);
+    glGenBuffers(1, &instance_VBO_);
+
+    glBindVertexArray(quad_VAO_);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quad_VBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), reinterpret_cast<void*>(0));
+
+    // Per instance attributes advance once per quad instead of once per vertex
+    glBindBuffer(GL_ARRAY_BUFFER, instance_VBO_);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    set_instance_offset(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+// GL 3.3 has no base instance for instanced draws, so every group points the
+// instance attributes at its first sprite instead. Needs the VAO and the
+// instance buffer bound.
+void gcom::SpriteBatch::set_instance_offset(size_t first)
+{
+    const size_t offset{ first * sizeof(Instance) };
+    glVertexAttribPointer(
+        1,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Instance),
+        reinterpret_cast<void*>(offset + offsetof(Instance, rect)));
+    glVertexAttribPointer(
+        2,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Instance),
+        reinterpret_cast<void*>(offset + offsetof(Instance, color_rotation)));
+}
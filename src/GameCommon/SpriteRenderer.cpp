@@ -2,8 +2,11 @@
 #include <GameCommon/SpriteRenderer.h>
 
 #include <GameCommon/Common.h>
+#include <GameCommon/GLCounters.h>
 
-gcom::SpriteRenderer::SpriteRenderer(const Shader& shader) : shader_{ shader }
+gcom::SpriteRenderer::SpriteRenderer(const Shader& shader)
+    : shader_{ shader }, model_{ shader.uniform<glm::mat4>("model") },
+      sprite_color_{ shader.uniform<glm::vec3>("sprite_color") }
 {
     init_render_data();
 }
@@ -27,14 +30,15 @@ void gcom::SpriteRenderer::draw_sprite(const Texture2D& texture, const glm::vec2
 
     model = glm::scale(model, glm::vec3{ size, 1.0f });
 
-    shader_.set_matrix4("model", model);
-    shader_.set_vector3f("sprite_color", color);
+    shader_.set(model_, model);
+    shader_.set(sprite_color_, color);
 
     glActiveTexture(GL_TEXTURE0);
     texture.bind();
 
     glBindVertexArray(quad_VAO_);
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    ++gl_counters.draw_calls;
     glBindVertexArray(0);
 }
 
@@ -0,0 +1,87 @@
+#include <GameCommon/Sweep.h>
+#include <GameCommon/Types.h>
+
+namespace
+{
+// When and for how long a point moving by `delta` from `from` is inside
+// [min, max] on one axis
+bool slab(float from, float delta, float min, float max, float& enter, float& exit)
+{
+    if (delta == 0.0f)
+    {
+        return from >= min && from <= max;
+    }
+
+    float t0{ (min - from) / delta };
+    float t1{ (max - from) / delta };
+    if (t0 > t1)
+    {
+        std::swap(t0, t1);
+    }
+    enter = std::max(enter, t0);
+    exit  = std::min(exit, t1);
+    return true;
+}
+} // namespace
+
+// The circle touches the box exactly when its center is inside the box grown by
+// the radius with rounded corners. The center's path is first clipped against
+// the grown box without rounding. If it enters through one of the corner
+// squares, the real contact is with the quarter circle around the box corner
+// there (Ericson, Real-Time Collision Detection, 5.5.7).
+std::optional<float> gcom::sweep_circle_box(const glm::vec2& from,
+                                            const glm::vec2& to, float radius,
+                                            const glm::vec2& box_pos,
+                                            const glm::vec2& box_size)
+{
+    const glm::vec2 delta{ to - from };
+    const glm::vec2 box_max{ box_pos + box_size };
+    if (delta.x == 0.0f && delta.y == 0.0f)
+    {
+        return std::nullopt;
+    }
+
+    float enter{ -std::numeric_limits<float>::max() };
+    float exit{ std::numeric_limits<float>::max() };
+    const glm::vec2 grown_min{ box_pos.x - radius, box_pos.y - radius };
+    const glm::vec2 grown_max{ box_max.x + radius, box_max.y + radius };
+    if (!slab(from.x, delta.x, grown_min.x, grown_max.x, enter, exit) ||
+        !slab(from.y, delta.y, grown_min.y, grown_max.y, enter, exit))
+    {
+        return std::nullopt;
+    }
+    // Moving away from a box it touches gives enter == exit, so that is a miss too
+    if (enter >= exit || exit < 0.0f || enter > 1.0f)
+    {
+        return std::nullopt;
+    }
+
+    // Starting inside the grown box is fine as long as it's in a corner square
+    // but outside the quarter circle
+    const glm::vec2 contact{ from + delta * std::max(enter, 0.0f) };
+    const bool beside_x{ contact.x < box_pos.x || contact.x > box_max.x };
+    const bool beside_y{ contact.y < box_pos.y || contact.y > box_max.y };
+    if (!beside_x || !beside_y)
+    {
+        return enter >= 0.0f ? std::optional<float>{ enter } : std::nullopt;
+    }
+
+    // Corner square: the first time the center is `radius` away from the corner
+    const glm::vec2 corner{ contact.x < box_pos.x ? box_pos.x : box_max.x,
+                            contact.y < box_pos.y ? box_pos.y : box_max.y };
+    const glm::vec2 m{ from - corner };
+    const float a{ glm::dot(delta, delta) };
+    const float b{ glm::dot(m, delta) };
+    const float c{ glm::dot(m, m) - radius * radius };
+    const float discriminant{ b * b - a * c };
+    if (discriminant < 0.0f)
+    {
+        return std::nullopt;
+    }
+    const float t{ (-b - std::sqrt(discriminant)) / a };
+    if (t < 0.0f || t > 1.0f)
+    {
+        return std::nullopt;
+    }
+    return t;
+}
@@ -1,40 +1,74 @@
 #include <GameCommon/Common.h>
+#include <GameCommon/GLCounters.h>
 #include <GameCommon/TextRenderer.h>
 #include <GameCommon/ResourceManager.h>
 
-gcom::TextRender::TextRender(u32 width, u32 height)
+gcom::TextRender::TextRender()
 {
     // load and configure shader
     shader_ =
         ResourceManager::load_shader("res/shaders/text_2d.vert", "res/shaders/text_2d.frag", "", "text");
 
-    shader_.set_matrix4(
-        "projection",
-        glm::ortho(
-            0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f),
-        true);
+    shader_.set_integer("text", 0, true);
+    origin_ = shader_.uniform<glm::vec2>("origin");
+    tint_   = shader_.uniform<glm::vec3>("tint");
 
-    shader_.set_integer("text", 0);
     // configure VAO/VBO for texture quads
     glGenVertexArrays(1, &VAO_);
     glGenBuffers(1, &VBO_);
-
     glBindVertexArray(VAO_);
     glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+    set_vertex_attributes();
+
+    // and for the cached runs, which live in one buffer that is only appended to
+    glGenVertexArrays(1, &run_VAO_);
+    glGenBuffers(1, &run_VBO_);
+    glBindVertexArray(run_VAO_);
+    glBindBuffer(GL_ARRAY_BUFFER, run_VBO_);
+    glBufferData(
+        GL_ARRAY_BUFFER, RUN_CAPACITY * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    set_vertex_attributes();
 
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
+void gcom::TextRender::set_vertex_attributes()
+{
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0,
+                          4,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(Vertex),
+                          reinterpret_cast<void*>(offsetof(Vertex, pos_uv)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1,
+                          3,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(Vertex),
+                          reinterpret_cast<void*>(offsetof(Vertex, color)));
+}
+
+gcom::TextRender::~TextRender()
+{
+    glDeleteVertexArrays(1, &VAO_);
+    glDeleteBuffers(1, &VBO_);
+    glDeleteVertexArrays(1, &run_VAO_);
+    glDeleteBuffers(1, &run_VBO_);
+    glDeleteTextures(1, &atlas_);
+}
+
 void gcom::TextRender::load(std::string_view font, u32 font_size)
 {
-    // first clear the previously loaded Characters
-    characters_.clear();
-    // then initialize and load the FreeType library
+    load(rasterize(font, font_size));
+}
+
+gcom::GlyphAtlas gcom::TextRender::rasterize(std::string_view font, u32 font_size)
+{
+    GlyphAtlas atlas{};
+    // initialize and load the FreeType library
     FT_Library ft{};
     if (FT_Init_FreeType(&ft))
     {
@@ -50,11 +84,17 @@ void gcom::TextRender::load(std::string_view font, u32 font_size)
 
     // set size to load glyphs as
     FT_Set_Pixel_Sizes(face, 0, font_size);
-    // disable byte-aligment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    // then for the 1st 128 ASCII characters, pre-load/compile their characters and
-    // store the
-    for (GLubyte c{ 0 }; c < 128; ++c)
+
+    // Rasterize the 1st 128 ASCII characters and place them on shelves, left to
+    // right and top to bottom. Every glyph gets a one pixel border repeating its
+    // edge, so linear filtering sees what GL_CLAMP_TO_EDGE gave a glyph of its own
+    constexpr i32 ATLAS_WIDTH{ 1024 };
+    constexpr i32 PADDING{ 2 };
+    std::array<std::vector<u8>, GLYPH_COUNT> bitmaps{};
+    std::array<glm::ivec2, GLYPH_COUNT> origins{};
+    glm::ivec2 cursor{ PADDING, PADDING };
+    i32 shelf_height{ 0 };
+    for (u32 c{ 0 }; c < GLYPH_COUNT; ++c)
     {
         // load character glyph
         if (FT_Load_Char(face, c, FT_LOAD_RENDER))
@@ -63,88 +103,262 @@ void gcom::TextRender::load(std::string_view font, u32 font_size)
             continue;
         }
 
-        // generate texture
-        u32 texture{};
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     GL_RED,
-                     face->glyph->bitmap.width,
-                     face->glyph->bitmap.rows,
-                     0,
-                     GL_RED,
-                     GL_UNSIGNED_BYTE,
-                     face->glyph->bitmap.buffer);
-
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        const FT_Bitmap& bitmap{ face->glyph->bitmap };
+        const glm::ivec2 size{ static_cast<i32>(bitmap.width),
+                               static_cast<i32>(bitmap.rows) };
+        if (cursor.x + size.x + PADDING > ATLAS_WIDTH)
+        {
+            cursor.x = PADDING;
+            cursor.y += shelf_height + PADDING;
+            shelf_height = 0;
+        }
+        origins[c] = cursor;
+        cursor.x += size.x + PADDING;
+        shelf_height = std::max(shelf_height, size.y);
+
+        // rows can be padded in FreeType bitmaps, copy them tightly
+        bitmaps[c].resize(static_cast<size_t>(size.x) * size.y);
+        for (i32 row{ 0 }; row < size.y; ++row)
+        {
+            std::copy_n(bitmap.buffer + row * bitmap.pitch,
+                        size.x,
+                        bitmaps[c].begin() + row * size.x);
+        }
 
         // now store character for later use
-        Character character{
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+        atlas.characters[c] = Character{
+            glm::vec2{ 0.0f },
+            glm::vec2{ 0.0f },
+            size,
             glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
             static_cast<u32>(face->glyph->advance.x)
         };
-
-        characters_.insert(std::pair<char, Character>{ c, character });
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
     // destroy FreeType once we're finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
+
+    atlas.width  = ATLAS_WIDTH;
+    atlas.height = cursor.y + shelf_height + PADDING;
+    atlas.pixels.assign(static_cast<size_t>(atlas.width) * atlas.height, 0);
+    for (u32 c{ 0 }; c < GLYPH_COUNT; ++c)
+    {
+        Character& ch{ atlas.characters[c] };
+        if (ch.size.x > 0 && ch.size.y > 0)
+        {
+            for (i32 row{ -1 }; row <= ch.size.y; ++row)
+            {
+                const i32 src_row{ std::clamp(row, 0, ch.size.y - 1) };
+                for (i32 col{ -1 }; col <= ch.size.x; ++col)
+                {
+                    const i32 src_col{ std::clamp(col, 0, ch.size.x - 1) };
+                    atlas.pixels[(origins[c].y + row) * ATLAS_WIDTH + origins[c].x +
+                                 col] = bitmaps[c][src_row * ch.size.x + src_col];
+                }
+            }
+        }
+        const glm::vec2 texel{ 1.0f / ATLAS_WIDTH, 1.0f / atlas.height };
+        ch.uv_min = glm::vec2{ origins[c].x * texel.x, origins[c].y * texel.y };
+        ch.uv_max = glm::vec2{ (origins[c].x + ch.size.x) * texel.x,
+                               (origins[c].y + ch.size.y) * texel.y };
+    }
+    return atlas;
 }
 
-void gcom::TextRender::render_text(const std::string text, float x, float y,
-                                 float scale, const glm::vec3 color)
+void gcom::TextRender::load(const GlyphAtlas& atlas)
 {
-    // active corresponding render state
-    shader_.use();
-    shader_.set_vector3f("text_color", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO_);
+    // drop what was laid out with the previous Characters
+    characters_ = atlas.characters;
+    runs_.clear();
+    run_vertices_used_ = 0;
+    cap_height_        = static_cast<float>(characters_['H'].bearing.y);
+
+    // generate texture
+    glDeleteTextures(1, &atlas_);
+    glGenTextures(1, &atlas_);
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+    // disable byte-aligment restriction
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 GL_RED,
+                 atlas.width,
+                 atlas.height,
+                 0,
+                 GL_RED,
+                 GL_UNSIGNED_BYTE,
+                 atlas.pixels.data());
+
+    // set texture options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
 
+void gcom::TextRender::add_text(std::string_view text, float x, float y,
+                                float scale, const glm::vec3& color)
+{
+    layout(text, x, y, scale, color, vertices_);
+}
+
+void gcom::TextRender::layout(std::string_view text, float x, float y, float scale,
+                              const glm::vec3& color,
+                              std::vector<Vertex>& out) const
+{
     // iterate throung all characters
-    std::string::const_iterator cit;
-    for (cit = text.begin(); cit != text.end(); ++cit)
+    for (const char c : text)
     {
-        Character ch = characters_[*cit];
-
-        float xpos{ x + ch.bearing.x * scale };
-        float ypos{ y + (characters_['H'].bearing.y - ch.bearing.y) * scale };
-
-        float w{ ch.size.y * scale };
-        float h{ ch.size.y * scale };
-        // update VBO for each character
-        std::array<std::array<float, 4>, 6> vertices = {
-            { { { xpos, ypos + h, 0.0f, 1.0f } },
-              { { xpos + w, ypos, 1.0f, 0.0f } },
-              { { xpos, ypos, 0.0f, 0.0f } },
-              { { xpos, ypos + h, 0.0f, 1.0f } },
-              { { xpos + w, ypos + h, 1.0f, 1.0f } },
-              { { xpos + w, ypos, 1.0f, 0.0f } } }
-        };
+        const auto code{ static_cast<u8>(c) };
+        if (code >= GLYPH_COUNT)
+        {
+            continue;
+        }
+        const Character& ch{ characters_[code] };
+
+        const float xpos{ x + ch.bearing.x * scale };
+        const float ypos{ y + (cap_height_ - ch.bearing.y) * scale };
+
+        const float w{ ch.size.y * scale };
+        const float h{ ch.size.y * scale };
+        const glm::vec2& uv0{ ch.uv_min };
+        const glm::vec2& uv1{ ch.uv_max };
+        const auto vertex = [&](float vx, float vy, float u, float v)
+        { out.push_back(Vertex{ glm::vec4{ vx, vy, u, v }, color }); };
+        // two triangles per glyph
+        vertex(xpos, ypos + h, uv0.x, uv1.y);
+        vertex(xpos + w, ypos, uv1.x, uv0.y);
+        vertex(xpos, ypos, uv0.x, uv0.y);
+        vertex(xpos, ypos + h, uv0.x, uv1.y);
+        vertex(xpos + w, ypos + h, uv1.x, uv1.y);
+        vertex(xpos + w, ypos, uv1.x, uv0.y);
 
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.texture_id);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-        glBufferSubData(
-            GL_ARRAY_BUFFER,
-            0,
-            sizeof(vertices),
-            vertices.data()); // be sure to use glBufferSubData and not glBufferData
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
         // now advance cursors for the next glyph
         x += (ch.advance >> 6) *
              scale; // bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
     }
+}
+
+void gcom::TextRender::flush()
+{
+    if (vertices_.empty())
+    {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+    if (vertices_.size() > vertex_capacity_)
+    {
+        vertex_capacity_ = std::max(vertices_.size(), vertex_capacity_ * 2);
+    }
+    // orphan the storage of the last flush so the driver doesn't wait for it
+    glBufferData(
+        GL_ARRAY_BUFFER, vertex_capacity_ * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(
+        GL_ARRAY_BUFFER, 0, vertices_.size() * sizeof(Vertex), vertices_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // active corresponding render state, queued text is laid out in place
+    shader_.use();
+    shader_.set(origin_, glm::vec2{ 0.0f });
+    shader_.set(tint_, glm::vec3{ 1.0f });
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+    glBindVertexArray(VAO_);
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices_.size()));
+    ++gl_counters.draw_calls;
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
+
+    vertices_.clear();
+}
+
+void gcom::TextRender::render_text(std::string_view text, float x, float y,
+                                   float scale, const glm::vec3& color)
+{
+    add_text(text, x, y, scale, color);
+    flush();
+}
+
+void gcom::TextRender::draw_run(std::string_view text, float x, float y,
+                                float scale, const glm::vec3& color)
+{
+    const Run& run{ find_or_add_run(text, scale) };
+    if (run.count == 0)
+    {
+        return;
+    }
+
+    shader_.use();
+    shader_.set(origin_, glm::vec2{ x, y });
+    shader_.set(tint_, color);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+    glBindVertexArray(run_VAO_);
+    glDrawArrays(GL_TRIANGLES, run.first, run.count);
+    ++gl_counters.draw_calls;
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+size_t gcom::TextRender::cached_run_count() const
+{
+    size_t count{ 0 };
+    for (const auto& [scale, runs] : runs_)
+    {
+        count += runs.size();
+    }
+    return count;
+}
+
+const gcom::TextRender::Run& gcom::TextRender::find_or_add_run(std::string_view text,
+                                                               float scale)
+{
+    auto by_scale{ std::find_if(runs_.begin(),
+                                runs_.end(),
+                                [scale](const auto& entry)
+                                { return entry.first == scale; }) };
+    if (by_scale != runs_.end())
+    {
+        const auto found{ by_scale->second.find(text) };
+        if (found != by_scale->second.end())
+        {
+            return found->second;
+        }
+    }
+
+    // laid out at the origin in white, draw_run() moves and tints it
+    run_layout_.clear();
+    layout(text, 0.0f, 0.0f, scale, glm::vec3{ 1.0f }, run_layout_);
+    const auto count{ static_cast<i32>(run_layout_.size()) };
+    if (count > RUN_CAPACITY)
+    {
+        std::cerr << "ERROR::TEXT: Text run too long to cache\n";
+        static const Run empty{ 0, 0 };
+        return empty;
+    }
+
+    // out of room, drop every run and start over
+    if (run_vertices_used_ + count > RUN_CAPACITY)
+    {
+        runs_.clear();
+        run_vertices_used_ = 0;
+        by_scale           = runs_.end();
+    }
+    if (by_scale == runs_.end())
+    {
+        by_scale = runs_.emplace(runs_.end(), scale, RunMap{});
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, run_VBO_);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    run_vertices_used_ * sizeof(Vertex),
+                    count * sizeof(Vertex),
+                    run_layout_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    const Run run{ run_vertices_used_, count };
+    run_vertices_used_ += count;
+    return by_scale->second.emplace(std::string{ text }, run).first->second;
 }
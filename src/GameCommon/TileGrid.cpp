@@ -0,0 +1,48 @@
+#include <GameCommon/TileGrid.h>
+#include <GameCommon/Types.h>
+
+gcom::TileGrid::TileGrid(u32 columns, u32 rows, const glm::vec2& tile_size)
+    : columns_{ columns }, rows_{ rows }, tile_size_{ tile_size },
+      tiles_(static_cast<size_t>(columns) * rows, EMPTY)
+{
+}
+
+void gcom::TileGrid::set(u32 column, u32 row, u32 brick)
+{
+    tiles_[static_cast<size_t>(row) * columns_ + column] = brick;
+}
+
+void gcom::TileGrid::query(const glm::vec2& min, const glm::vec2& max,
+                           std::vector<u32>& bricks) const
+{
+    bricks.clear();
+    if (tiles_.empty() || max.x < 0.0f || max.y < 0.0f)
+    {
+        return;
+    }
+
+    // clamp to the grid, nothing outside it holds a brick
+    const float first_column{ std::max(min.x / tile_size_.x, 0.0f) };
+    const float first_row{ std::max(min.y / tile_size_.y, 0.0f) };
+    if (first_column >= columns_ || first_row >= rows_)
+    {
+        return;
+    }
+    const auto last_column{ static_cast<u32>(
+        std::min(max.x / tile_size_.x, static_cast<float>(columns_ - 1))) };
+    const auto last_row{ static_cast<u32>(
+        std::min(max.y / tile_size_.y, static_cast<float>(rows_ - 1))) };
+
+    for (auto row{ static_cast<u32>(first_row) }; row <= last_row; ++row)
+    {
+        const u32* tiles{ tiles_.data() + static_cast<size_t>(row) * columns_ };
+        for (auto column{ static_cast<u32>(first_column) }; column <= last_column;
+             ++column)
+        {
+            if (tiles[column] != EMPTY)
+            {
+                bricks.push_back(tiles[column]);
+            }
+        }
+    }
+}
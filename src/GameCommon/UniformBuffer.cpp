@@ -0,0 +1,37 @@
+#include <GameCommon/UniformBuffer.h>
+#include <GameCommon/Common.h>
+#include <GameCommon/GLCounters.h>
+
+#include <cassert>
+
+std::string_view gcom::uniform_block_name(UniformBlock block)
+{
+    switch (block)
+    {
+    case UniformBlock::View:
+        return "View";
+    case UniformBlock::Effects:
+        return "Effects";
+    }
+    return "";
+}
+
+gcom::UniformBuffer::UniformBuffer(UniformBlock block, size_t size) : size_{ size }
+{
+    glGenBuffers(1, &id_);
+    glBindBuffer(GL_UNIFORM_BUFFER, id_);
+    glBufferData(GL_UNIFORM_BUFFER, size_, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<u32>(block), id_);
+}
+
+gcom::UniformBuffer::~UniformBuffer() { glDeleteBuffers(1, &id_); }
+
+void gcom::UniformBuffer::update(const void* data, size_t size)
+{
+    assert(size == size_);
+    glBindBuffer(GL_UNIFORM_BUFFER, id_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    ++gl_counters.buffer_updates;
+}